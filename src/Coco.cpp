@@ -64,9 +64,11 @@ int main(int argc, char *argv_[]) {
 	wprintf(_SC("%s"), "Coco/R (Dec 01, 2018)\n");
 
 	wchar_t *srcName = NULL, *nsName = NULL, *frameDir = NULL, *ddtString = NULL, *traceFileName = NULL;
-	wchar_t *outDir = NULL;
+	wchar_t *outDir = NULL, *profileName = NULL, *scannerProfileName = NULL;
 	char *chTrFileName = NULL;
 	bool emitLines = false, ignoreGammarErrors = false, genRREBNF = false;
+	bool renumberTerminals = false, parserTables = false, recognizer = false;
+	bool badOption = false;
 
 	for (int i = 1; i < argc; i++) {
 		if (coco_string_equal(argv[i], _SC("-namespace")) && i < argc - 1) nsName = coco_string_create(argv[++i]);
@@ -76,6 +78,19 @@ int main(int argc, char *argv_[]) {
 		else if (coco_string_equal(argv[i], _SC("-lines"))) emitLines = true;
 		else if (coco_string_equal(argv[i], _SC("-genRREBNF"))) genRREBNF = true;
 		else if (coco_string_equal(argv[i], _SC("-ignoreGammarErrors"))) ignoreGammarErrors = true;
+		else if (coco_string_equal(argv[i], _SC("-renumberTerminals"))) renumberTerminals = true;
+		else if (coco_string_equal(argv[i], _SC("-parser")) && i < argc - 1) {
+			i++;
+			if (coco_string_equal(argv[i], _SC("tables"))) parserTables = true;
+			else if (coco_string_equal(argv[i], _SC("recursive"))) parserTables = false;
+			else {
+				wprintf(_SC("-- unknown parser %") _SFMT _SC(", use recursive or tables\n"), argv[i]);
+				badOption = true;
+			}
+		}
+		else if (coco_string_equal(argv[i], _SC("-recognizer"))) recognizer = true;
+		else if (coco_string_equal(argv[i], _SC("-profile")) && i < argc - 1) profileName = coco_string_create(argv[++i]);
+		else if (coco_string_equal(argv[i], _SC("-scannerProfile")) && i < argc - 1) scannerProfileName = coco_string_create(argv[++i]);
 		else srcName = coco_string_create(argv[i]);
 	}
 
@@ -86,7 +101,7 @@ int main(int argc, char *argv_[]) {
 	delete [] argv; argv = NULL;
 #endif
 
-	if (argc > 0 && srcName != NULL) {
+	if (argc > 0 && srcName != NULL && !badOption) {
 		int pos = coco_string_lastindexof(srcName, '/');
 		if (pos < 0) pos = coco_string_lastindexof(srcName, '\\');
 		wchar_t* file = coco_string_create(srcName);
@@ -111,6 +126,11 @@ int main(int argc, char *argv_[]) {
 		tab.outDir   = coco_string_create(outDir != NULL ? outDir : srcDir);
 		tab.emitLines = emitLines;
 		tab.genRREBNF = genRREBNF;
+		tab.renumberTerminals = renumberTerminals;
+		tab.parserTables = parserTables;
+		tab.recognizer = recognizer;
+		tab.profileName = profileName ? coco_string_create(profileName) : NULL;
+		tab.scannerProfileName = scannerProfileName ? coco_string_create(scannerProfileName) : NULL;
 		parser.ignoreGammarErrors = ignoreGammarErrors;
 		if (ddtString != NULL) tab.SetDDT(ddtString);
 		parser.tab  = &tab;
@@ -154,6 +174,11 @@ int main(int argc, char *argv_[]) {
                     "  -lines\n"
                     "  -genRREBNF\n"
                     "  -ignoreGammarErrors\n"
+                    "  -renumberTerminals\n"
+                    "  -parser    recursive|tables\n"
+                    "  -recognizer   (accept/reject only, stops at the first error)\n"
+                    "  -profile   <profileFile>   (written by Parser::PrintProfile)\n"
+                    "  -scannerProfile <profileFile>   (written by ScannerStats::Print)\n"
                     "Valid characters in the trace string:\n"
                     "  A  trace automaton\n"
                     "  F  list first/follow sets\n"
@@ -174,6 +199,8 @@ int main(int argc, char *argv_[]) {
 	coco_string_delete(chTrFileName);
 	coco_string_delete(traceFileName);
 	coco_string_delete(outDir);
+	coco_string_delete(profileName);
+	coco_string_delete(scannerProfileName);
 
-	return 0;
+	return badOption ? 1 : 0;
 }
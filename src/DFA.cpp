@@ -715,6 +715,94 @@ void DFA::CopySourcePart (const Position *pos, int indent) {
         parser->pgen->buffer->SetPos(oldPos);
 }
 
+// Reads the hits of the transitions from a profile written by
+// ScannerStats::Print into profStates and profHits.
+void DFA::ReadProfile() {
+	char *fileName = coco_string_create_char(tab->scannerProfileName);
+	FILE *f = fopen(fileName, "rb");
+	delete [] fileName;
+	if (f == NULL) {
+		wchar_t *message = coco_string_create_append(_SC("-- Cannot open scanner profile: "), tab->scannerProfileName);
+		errors->Exception(message);
+		delete [] message;
+		return;
+	}
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char *text = new char[len + 1];
+	len = (long) fread(text, 1, len, f);
+	text[len] = 0;
+	fclose(f);
+
+	const char *transKey = "\"transitions\": [", *stateKey = "{\"state\": ", *hitsKey = ", \"hits\": [";
+	const char *s = strstr(text, transKey);
+	if (s != NULL) s += strlen(transKey);
+	while (s != NULL && strncmp(s, stateKey, strlen(stateKey)) == 0) {
+		char *next;
+		int nr = (int) strtol(s + strlen(stateKey), &next, 10);
+		if (strncmp(next, hitsKey, strlen(hitsKey)) != 0) break;
+		s = next + strlen(hitsKey);
+		int first = profHits.Count;
+		while (*s != ']' && *s != 0) {
+			profHits.Add(strtoll(s, &next, 10));
+			if (next == s) break;
+			s = next;
+			if (*s == ',') s++;
+		}
+		profStates.Add(nr); profStates.Add(profHits.Count - first); profStates.Add(first);
+		if (strncmp(s, "]}", 2) != 0) break;
+		s += 2;
+		if (*s == ',') s += 2;
+	}
+	delete [] text;
+
+	// the automaton must be the one that was profiled
+	profIndex = new int[lastStateNr + 1];
+	for (int i = 0; i <= lastStateNr; i++) profIndex[i] = -1;
+	bool match = true;
+	for (int k = 0; k < profStates.Count; k += 3) {
+		if (profStates[k] < 0 || profStates[k] > lastStateNr) { match = false; break; }
+		profIndex[profStates[k]] = k;
+	}
+	for (State *state = firstState->next; state != NULL && match; state = state->next) {
+		int n = 1;
+		for (Action *a = state->firstAction; a != NULL; a = a->next) n++;
+		int k = profIndex[state->nr];
+		if (k < 0 || profStates[k+1] != n) match = false;
+	}
+	if (!match) {
+		errors->Warning(_SC("-scannerProfile: the profile does not match the automaton, it is not used"));
+		delete [] profIndex;
+		profIndex = NULL;
+	}
+}
+
+// true if the profile was read and the scanner never was in state
+bool DFA::IsCold(const State *state) {
+	if (profIndex == NULL) return false;
+	int k = profIndex[state->nr];
+	for (int i = 0; i < profStates[k+1]; i++)
+		if (profHits[profStates[k+2] + i] > 0) return false;
+	return true;
+}
+
+// Numbers the transition counters: per state one for each action and one for
+// leaving the state, in the order of the actions, not of the generated tests.
+void DFA::WriteTransitionTable() {
+	transitionBase = new int[lastStateNr + 1];
+	int n = 0;
+	fputws(_SC("#ifdef COCO_SCANNER_STATS\n\tstatic const int transitionStates[] = {"), gen);
+	for (State *state = firstState->next; state != NULL; state = state->next) {
+		int actions = 0;
+		for (Action *a = state->firstAction; a != NULL; a = a->next) actions++;
+		transitionBase[state->nr] = n;
+		n += actions + 1;
+		fwprintf(gen, _SC("%d, %d, "), state->nr, actions);
+	}
+	fputws(_SC("-1}; // state, number of transitions\n\tstats.InitTransitions(transitionStates);\n#endif\n"), gen);
+}
+
 void DFA::WriteState(const State *state) {
 	Symbol *endOf = state->endOf;
 	fwprintf(gen, _SC("\t\tcase %d:\n"), state->nr);
@@ -726,26 +814,54 @@ void DFA::WriteState(const State *state) {
 	}
 	bool ctxEnd = state->ctx;
 
-        wchar_t_20 fmt;
+	// the actions are disjoint, so they can be tested in any order; with a
+	// profile (-scannerProfile) the most frequent one is tested first
+	int n = 0;
+	for (Action *action = state->firstAction; action != NULL; action = action->next) n++;
+	Action **actions = new Action*[n + 1];
+	int *actionNr = new int[n + 1];
+	n = 0;
 	for (Action *action = state->firstAction; action != NULL; action = action->next) {
-		if (action == state->firstAction) fputws(_SC("\t\t\tif ("), gen);
+		actions[n] = action; actionNr[n] = n; n++;
+	}
+	if (profIndex != NULL) {
+		int hits = profStates[profIndex[state->nr] + 2];
+		for (int i = 1; i < n; i++) {  // stable, so actions with equal hits keep their order
+			for (int j = i; j > 0 && profHits[hits + actionNr[j]] > profHits[hits + actionNr[j-1]]; j--) {
+				Action *a = actions[j]; actions[j] = actions[j-1]; actions[j-1] = a;
+				int nr = actionNr[j]; actionNr[j] = actionNr[j-1]; actionNr[j-1] = nr;
+			}
+		}
+	}
+	int base = transitionBase[state->nr];
+
+        wchar_t_20 fmt;
+	for (int i = 0; i < n; i++) {
+		Action *action = actions[i];
+		// transitions that the profile never saw, e.g. into cold states
+		bool cold = profIndex != NULL && profHits[profStates[profIndex[state->nr] + 2] + actionNr[i]] == 0;
+		if (i == 0) fputws(_SC("\t\t\tif ("), gen);
 		else fputws(_SC("\t\t\telse if ("), gen);
+		if (cold) fputws(_SC("COCO_UNLIKELY("), gen);
 		if (action->typ == NodeType::chr) {
 			wchar_t* res = DFAChCond(action->sym, fmt);
 			fwprintf(gen, _SC("%") _SFMT, res);
 		} else PutRange(tab->CharClassSet(action->sym));
-		fputws(_SC(") {"), gen);
+		fputws(cold ? _SC(")) {") : _SC(") {"), gen);
 
 		if (action->tc == TransitionCode::contextTrans) {
 			fputws(_SC("apx++; "), gen); ctxEnd = false;
 		} else if (state->ctx)
 			fputws(_SC("apx = 0; "), gen);
-		fwprintf(gen, _SC("AddCh(); goto case_%d;}\n"), action->target->state->nr);
+		fwprintf(gen, _SC("COCO_TRANSITION(%d); AddCh(); goto case_%d;}\n"), base + actionNr[i], action->target->state->nr);
 	}
+	delete [] actions;
+	delete [] actionNr;
 	if (state->firstAction == NULL)
 		fputws(_SC("\t\t\t{"), gen);
 	else
 		fputws(_SC("\t\t\telse {"), gen);
+	fwprintf(gen, _SC("COCO_TRANSITION(%d); "), base + n);
 	if (ctxEnd) { // final context state: cut appendix
 		fwprintf(gen, _SC("%s"),
                             "\n"
@@ -845,6 +961,8 @@ void DFA::WriteScanner() {
 	fwprintf(gen, _SC("\tnoSym = %d;\n"), tab->noSym->n);
 	WriteStartTab();
 	GenLiterals();
+	if (tab->scannerProfileName != NULL) ReadProfile();
+	WriteTransitionTable();
 
 	g.CopyFramePart(_SC("-->initialization"));
 	g.CopyFramePart(_SC("-->casing1"));
@@ -891,8 +1009,15 @@ void DFA::WriteScanner() {
 	existLabel = new bool[lastStateNr+1];
 	CheckLabels();
 	for (State *state = firstState->next; state != NULL; state = state->next)
-		WriteState(state);
+		if (!IsCold(state)) WriteState(state);
+	if (profIndex != NULL) {
+		// out of the way of the others
+		fputws(_SC("\t\t// states not entered with the profile (-scannerProfile)\n"), gen);
+		for (State *state = firstState->next; state != NULL; state = state->next)
+			if (IsCold(state)) WriteState(state);
+	}
 	delete [] existLabel;
+	delete [] transitionBase;
 
 	g.CopyFramePart(_SC("-->namespace_close"));
 	GenNamespaceClose(nrOfNs);
@@ -912,12 +1037,14 @@ DFA::DFA(Parser *parser) {
 	ignoreCase = false;
 	dirtyDFA = false;
 	hasCtxMoves = false;
+	transitionBase = profIndex = NULL;
 }
 
 DFA::~DFA() {
     delete firstState;
     delete firstComment;
     delete firstMelted;
+    delete [] profIndex;
 }
 
 }; // namespace
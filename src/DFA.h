@@ -62,6 +62,10 @@ public:
 	bool dirtyDFA;		// DFA may become nondeterministic in MatchLiteral
 	bool hasCtxMoves;	// DFA has context transitions
 	bool *existLabel;	// checking the Labels (in order to avoid the warning messages)
+	int *transitionBase;	// index of the first transition counter of each state (COCO_SCANNER_STATS)
+	TArrayList<int> profStates;	// -scannerProfile: state, number of counters and index in profHits
+	TArrayList<long long> profHits;	// hits of the transitions of the states, the exit last
+	int *profIndex;		// index of each state in profStates, -1: none
 
 	Parser     *parser;        // other Coco objects
 	Tab        *tab;
@@ -122,6 +126,9 @@ public:
 	void CopySourcePart (const Position *pos, int indent);
 	void WriteState(const State *state);
 	void WriteStartTab();
+	void WriteTransitionTable();
+	void ReadProfile();
+	bool IsCold(const State *state);
 	void OpenGen(const wchar_t* genName, bool backUp); /* pdt */
 	void WriteScanner();
 	DFA(Parser *parser);
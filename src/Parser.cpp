@@ -326,6 +326,7 @@ void Parser::Coco_NT() {
 		   tab->GrammarCheckAll();
 		 }
 		 else doGenCode = tab->GrammarOk();
+		 if (doGenCode && tab->renumberTerminals) tab->RenumberTerminals();
 		if(tab->genRREBNF && doGenCode) {
 		pgen->WriteRREBNF();
 		}
@@ -35,28 +35,98 @@ Coco/R itself) does not fall under the GNU General Public License.
 
 namespace Coco {
 
+static bool IsIdentChar(int ch) {
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+}
+
+// true if the identifier name occurs in text
+static bool UsesName(const wchar_t *text, const wchar_t *name) {
+	int len = coco_string_length(name);
+	for (const wchar_t *s = text; *s != 0; s++)
+		if (coco_string_equal_n(s, name, len) && !IsIdentChar(s[len])
+			&& (s == text || !IsIdentChar(s[-1]))) return true;
+	return false;
+}
+
 void ParserGen::Indent (int n) {
 	for (int i = 1; i <= n; i++) fputws(_SC("\t"), gen);
 }
 
-// use a switch if more than 5 alternatives and none starts with a resolver, and no LL1 warning
-bool ParserGen::UseSwitch (const Node *p) {
+// true if the alternatives of p can be tested in any order: no LL1 warning
+// and no alternative starts with a resolver
+bool ParserGen::IndependentAlts (const Node *p) {
 	BitArray *s2;
-	if (p->typ != NodeType::alt) return false;
-	int nAlts = 0;
 	BitArray s1(tab->terminals.Count);
 	while (p != NULL) {
 		s2 = tab->Expected0(p->sub, curSy);
-		// must not optimize with switch statement, if there are ll1 warnings
-		if (s1.Overlaps(s2)) {delete s2; return false; }
+		bool overlaps = s1.Overlaps(s2);
 		s1.Or(s2);
 		delete s2;
-		++nAlts;
-		// must not optimize with switch-statement, if alt uses a resolver expression
-		if (p->sub->typ == NodeType::rslv) return false;
+		if (overlaps || p->sub->typ == NodeType::rslv) return false;
 		p = p->down;
 	}
-	return nAlts > 5;
+	return true;
+}
+
+// cost of the condition that selects the alternative p
+int ParserGen::AltCost (const Node *p) {
+	CondTest test;
+	BitArray *s = tab->Expected0(p->sub, curSy);
+	BitArray *d = DerivationsOf(s);
+	int cost = CondCost(d, test);
+	delete d;
+	delete s;
+	return cost;
+}
+
+// use a switch if the conditions of an if-chain would cost more, and if
+// no alternative starts with a resolver, and no LL1 warning
+bool ParserGen::UseSwitch (const Node *p) {
+	if (p->typ != NodeType::alt || !IndependentAlts(p)) return false;
+	int chainCost = 0;
+	for (; p != NULL; p = p->down) chainCost += AltCost(p);
+	return chainCost > switchCost;
+}
+
+// Puts the alternatives of p into alts[0..n-1] in the order in which they are
+// tested and their numbers (in the grammar) into altNr. With a profile
+// (-profile) independent alternatives are ordered by their hits, and the
+// switch is chosen if the expected cost of the if-chain is higher.
+bool ParserGen::OrderAlts (const Node *p, int site, const Node **alts, int *altNr) {
+	int n = 0;
+	for (const Node *p2 = p; p2 != NULL; p2 = p2->down) { alts[n] = p2; altNr[n] = n; n++; }
+	int prof = ntProf[site];
+	if (prof < 0 || !IndependentAlts(p)) return UseSwitch(p);
+	long long total = 0;
+	for (int i = 0; i < n; i++) total += profHits[prof + i];
+	if (total == 0) return UseSwitch(p);
+	for (int i = 1; i < n; i++) {  // stable, so alternatives with equal hits keep their order
+		for (int j = i; j > 0 && profHits[prof + altNr[j]] > profHits[prof + altNr[j-1]]; j--) {
+			const Node *p2 = alts[j]; alts[j] = alts[j-1]; alts[j-1] = p2;
+			int nr = altNr[j]; altNr[j] = altNr[j-1]; altNr[j-1] = nr;
+		}
+	}
+	long long chainCost = 0;
+	int cost = 0;
+	for (int i = 0; i < n; i++) {
+		cost += AltCost(alts[i]);
+		chainCost += profHits[prof + altNr[i]] * cost;
+	}
+	return chainCost > (long long) switchCost * total;
+}
+
+// Collects the alternatives nodes of a production in the order of GenCode, so
+// that the counters of PARSER_PROFILE do not depend on the order of the code.
+void ParserGen::CollectAlts (const Node *p) {
+	while (p != NULL) {
+		if (p->typ == NodeType::alt) {
+			ntAlts.Add(p);
+			for (const Node *p2 = p; p2 != NULL; p2 = p2->down) CollectAlts(p2->sub);
+		} else if (p->typ == NodeType::iter || p->typ == NodeType::opt)
+			CollectAlts(p->sub);
+		if (p->up) break;
+		p = p->next;
+	}
 }
 
 int ParserGen::GenNamespaceOpen(const wchar_t *nsName) {
@@ -140,41 +210,138 @@ void ParserGen::GenErrorMsg (int errTyp, const Symbol *sym) {
 	coco_string_merge(err, format);
 }
 
+// Sets are kept with their derived tokens (see DerivationsOf), so that sets
+// which differ only in inherited tokens share one row of the set table.
 int ParserGen::NewCondSet (const BitArray *s) {
+	BitArray *d = DerivationsOf(s);
 	for (int i = 1; i < symSet.Count; i++) // skip symSet[0] (reserved for union of SYNC sets)
-		if (Sets::Equals(s, symSet[i])) return i;
-	symSet.Add(s->Clone());
+		if (Sets::Equals(d, symSet[i])) { delete d; return i; }
+	symSet.Add(d);
 	return symSet.Count - 1;
 }
 
-void ParserGen::GenCond (const BitArray *s, const Node *p) {
-	if (p->typ == NodeType::rslv) CopySourcePart(p->pos, 0);
-	else {
+// Estimates the cost of the cheapest test for la->kind in the derived set s:
+// comparisons for each run of consecutive token numbers (condRanges), a 64 bit
+// mask if the set spans less than 64 token numbers (condMask), or a lookup in
+// the set table (condTable).
+int ParserGen::CondCost (const BitArray *s, CondTest &test) {
+	int cost = 0, lo = -1, hi = -1;
+	for (int i=0; i<tab->terminals.Count; i++) {
+		if (!(*s)[i]) continue;
+		if (lo < 0) lo = i;
+		if (hi < 0 || i > hi + 1) cost += 1; // la->kind == i
+		else if (i == hi + 1 && (hi == lo || !(*s)[hi - 1])) cost += 1; // the run gets a lower and upper bound
+		hi = i;
+	}
+	test = condRanges;
+	if (tab->terminals.Count <= 64) { // all token kinds fit into the mask, no range check needed
+		if (maskCost - 1 < cost) { test = condMask; cost = maskCost - 1; }
+	} else if (lo >= 0 && hi - lo < 64) {
+		if (maskCost < cost) { test = condMask; cost = maskCost; }
+	}
+	if (tableCost < cost) { test = condTable; cost = tableCost; }
+	return cost;
+}
+
+// depth > 1: tests the kind of the depth-th token, LA(depth), instead of la
+void ParserGen::GenCond (const BitArray *s, const Node *p, int depth) {
+	if (depth == 1 && p->typ == NodeType::rslv) {
+		if (Memoized(p->pos)) {
+			int n = NewResolver(p->pos);
+			fwprintf(gen, _SC("(MemoHit(%d) ? memo[%d].val : Memo(%d, "), n, n, n);
+			CopySourcePart(p->pos, 0);
+			fputws(_SC("))"), gen);
+		} else CopySourcePart(p->pos, 0);
+	} else {
 		int n = Sets::Elements(s);
-		if (n == 0) fputws(_SC("false"), gen); // happens if an ANY set matches no symbol
-		else if (n <= maxTerm) {
-			Symbol *sym;
+		if (n == 0) { fputws(_SC("false"), gen); return; } // happens if an ANY set matches no symbol
+		BitArray *d = DerivationsOf(s);
+		CondTest test;
+		CondCost(d, test);
+		const size_t kindLen = 20;
+		wchar_t kind[kindLen];
+		if (depth == 1) coco_swprintf(kind, kindLen, _SC("la->kind"));
+		else coco_swprintf(kind, kindLen, _SC("LA(%d)"), depth);
+		if (test == condRanges) {
+			bool first = true;
 			for (int i=0; i<tab->terminals.Count; i++) {
-				sym = (Symbol*)tab->terminals[i];
-				if ((*s)[sym->n]) {
-					fputws(_SC("IsKind(la, "), gen);
-					WriteSymbolOrCode(gen, sym);
+				if (!(*d)[i] || (i > 0 && (*d)[i-1])) continue;
+				int j = i;
+				while (j+1 < tab->terminals.Count && (*d)[j+1]) j++;
+				if (!first) fputws(_SC(" || "), gen);
+				first = false;
+				if (i == j) {
+					fwprintf(gen, _SC("%") _SFMT _SC(" == "), kind); WriteSymbolOrCode(gen, tab->terminals[i]);
+				} else {
+					fwprintf(gen, _SC("(%") _SFMT _SC(" >= "), kind); WriteSymbolOrCode(gen, tab->terminals[i]);
+					fwprintf(gen, _SC(" && %") _SFMT _SC(" <= "), kind); WriteSymbolOrCode(gen, tab->terminals[j]);
 					fputws(_SC(")"), gen);
-					--n;
-					if (n > 0) fputws(_SC(" || "), gen);
 				}
 			}
-		} else
+		} else if (test == condMask) {
+			int lo = 0;
+			if (tab->terminals.Count > 64) while (!(*d)[lo]) lo++;
+			unsigned long long bits = 0;
+			for (int i = lo; i < lo + 64 && i < tab->terminals.Count; i++)
+				if ((*d)[i]) bits |= 1ULL << (i - lo);
+			if (tab->terminals.Count <= 64)
+				fwprintf(gen, _SC("((0x%llxULL >> %") _SFMT _SC(") & 1)"), bits, kind);
+			else
+				fwprintf(gen, _SC("((unsigned) (%") _SFMT _SC(" - %d) < 64 && ((0x%llxULL >> (%") _SFMT _SC(" - %d)) & 1))"), kind, lo, bits, kind, lo);
+		} else if (depth == 1)
 			fwprintf(gen, _SC("StartOf(%d /* %s */)"), NewCondSet(s), (tab->nTyp[p->typ]));
+		else
+			fwprintf(gen, _SC("StartOf(%d, %") _SFMT _SC(")"), NewCondSet(s), kind);
+		delete d;
+	}
+}
+
+// Condition of an alternative (look: its LL(k) sets) whose first terminals
+// overlap with those of the n later alternatives: each of these is ruled out
+// at the first token where they differ (Tab::LookDepth). Conflicts that
+// $lookahead does not resolve are left to the order of the alternatives.
+void ParserGen::GenLookCond(const BitArray *s, const Node *p, BitArray **look, BitArray ***later, int n) {
+	bool *depths = new bool[tab->lookahead + 1];
+	bool any = false;
+	for (int d = 0; d <= tab->lookahead; d++) depths[d] = false;
+	for (int j = 0; look != NULL && j < n; j++) {
+		if (later[j] == NULL || !look[0]->Overlaps(later[j][0])) continue;
+		int d = tab->LookDepth(look, later[j]);
+		if (d > 1) { depths[d] = true; any = true; }
+	}
+	if (any) fputws(_SC("("), gen);
+	GenCond(s, p);
+	if (any) {
+		fputws(_SC(")"), gen);
+		for (int d = 2; d <= tab->lookahead; d++) {
+			if (!depths[d]) continue;
+			fputws(_SC(" && ("), gen); GenCond(look[d-1], p, d); fputws(_SC(")"), gen);
+		}
 	}
+	delete [] depths;
 }
 
-void ParserGen::PutCaseLabels (const BitArray *s0) {
+// condition for entering the option or iteration p
+void ParserGen::GenOptCond(const BitArray *s, const Node *p) {
+	BitArray **look = NULL, **next = NULL;
+	if (tab->lookahead > 1 && p->sub->typ != NodeType::rslv) {
+		look = tab->LookSets(p->sub, curSy);
+		next = tab->LookSets(p->next, curSy);
+	}
+	GenLookCond(s, p->sub, look, &next, 1);
+	tab->DeleteLookSets(look);
+	tab->DeleteLookSets(next);
+}
+
+// labels holds the labels already used in the switch; with token inheritance
+// a derived token may also be in the set of a later alternative.
+void ParserGen::PutCaseLabels (const BitArray *s0, BitArray *labels) {
 	Symbol *sym;
 	BitArray *s = DerivationsOf(s0);
 	for (int i=0; i<tab->terminals.Count; i++) {
 		sym = tab->terminals[i];
-		if ((*s)[sym->n]) {
+		if ((*s)[sym->n] && !(*labels)[sym->n]) {
+			labels->Set(sym->n, true);
 			fputws(_SC("case "), gen);
 			WriteSymbolOrCode(gen, sym);
 			fputws(_SC(": "), gen);
@@ -185,21 +352,9 @@ void ParserGen::PutCaseLabels (const BitArray *s0) {
 
 BitArray *ParserGen::DerivationsOf(const BitArray *s0) {
 	BitArray *s = s0->Clone();
-	bool done = false;
-	while (!done) {
-		done = true;
-		for (int i=0; i<tab->terminals.Count; i++) {
-			Symbol *sym = tab->terminals[i];
-			if ((*s)[sym->n]) {
-				for (int i=0; i<tab->terminals.Count; i++) {
-					Symbol *baseSym = tab->terminals[i];
-					if (baseSym->inherits == sym && !(*s)[baseSym->n]) {
-						s->Set(baseSym->n, true);
-						done = false;
-					}
-				}
-			}
-		}
+	if (tab->hasInheritance) {
+		for (int i=0; i<tab->terminals.Count; i++)
+			if ((*s0)[i]) s->Or(tab->derivedSets[i]);
 	}
 	return s;
 }
@@ -211,9 +366,9 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 		if (p->typ == NodeType::nt) {
 			Indent(indent);
 			fwprintf(gen, _SC("%") _SFMT _SC("_NT("), p->sym->name);
-			CopySourcePart(p->pos, 0);
+			if (!tab->recognizer) CopySourcePart(p->pos, 0);
 			fputws(_SC(");\n"), gen);
-		} else if (p->typ == NodeType::t) {
+		} else if (p->typ == NodeType::t || (p->typ == NodeType::wt && tab->recognizer)) {
 			Indent(indent);
 			// assert: if isChecked[p->sym->n] is true, then isChecked contains only p->sym->n
 			if ((*isChecked)[p->sym->n]) {
@@ -224,8 +379,11 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 				WriteSymbolOrCode(gen, p->sym);
 				fputws(_SC(");\n"), gen);
 			}
-			fputws(_SC("#ifdef PARSER_WITH_AST\n\tAstAddTerminal();\n#endif\n"), gen);
-		} if (p->typ == NodeType::wt) {
+			if (!tab->recognizer) {
+				fputws(_SC("#ifdef PARSER_WITH_AST\n\tAstAddTerminal();\n#endif\n"), gen);
+				fputws(_SC("\tif (listener != NULL) listener->OnToken(t->kind, t);\n"), gen);
+			}
+		} else if (p->typ == NodeType::wt) {
 			Indent(indent);
 			s1 = tab->Expected(p->next, curSy);
 			s1->Or(tab->allSyncSets);
@@ -248,8 +406,8 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 		} if (p->typ == NodeType::eps) {	// nothing
 		} if (p->typ == NodeType::rslv) {	// nothing
 		} if (p->typ == NodeType::sem) {
-			CopySourcePart(p->pos, indent);
-		} if (p->typ == NodeType::nt_sync) {
+			if (!tab->recognizer) CopySourcePart(p->pos, indent);
+		} if (p->typ == NodeType::nt_sync && !tab->recognizer) {
 			Indent(indent);
 			GenErrorMsg(syncErr, curSy);
 			s1 = p->set->Clone();
@@ -260,28 +418,46 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 			s1 = tab->First(p);
 			bool equal = Sets::Equals(s1, isChecked);
                         delete s1;
-			bool useSwitch = UseSwitch(p);
+			int site = 0;
+			while (ntAlts[site] != p) site++;
+			int alts = 0;
+			for (p2 = p; p2 != NULL; p2 = p2->down) alts++;
+			const Node **altNodes = new const Node*[alts];
+			int *altNr = new int[alts];
+			bool useSwitch = OrderAlts(p, site, altNodes, altNr);
+			BitArray labels(tab->terminals.Count);
 			if (useSwitch) { Indent(indent); fputws(_SC("switch (la->kind) {\n"), gen); }
-			p2 = p;
-			while (p2 != NULL) {
+			BitArray ***look = new BitArray**[alts];  // LL(k) sets of the alternatives, see GenLookCond
+			for (int a = 0; a < alts; a++) look[a] = NULL;
+			if (tab->lookahead > 1 && !useSwitch && !IndependentAlts(p)) {
+				for (int a = 0; a < alts; a++)
+					if (altNodes[a]->sub->typ != NodeType::rslv) look[a] = tab->LookSets(altNodes[a]->sub, curSy);
+			}
+			for (int a = 0; a < alts; a++) {
+				p2 = altNodes[a];
 				s1 = tab->Expected(p2->sub, curSy);
 				Indent(indent);
 				if (useSwitch) {
-					PutCaseLabels(s1); fputws(_SC("{\n"), gen);
-				} else if (p2 == p) {
-					fputws(_SC("if ("), gen); GenCond(s1, p2->sub); fputws(_SC(") {\n"), gen);
-				} else if (p2->down == NULL && equal) { fputws(_SC("} else {\n"), gen);
+					PutCaseLabels(s1, &labels); fputws(_SC("{\n"), gen);
+				} else if (a == 0) {
+					fputws(_SC("if ("), gen); GenLookCond(s1, p2->sub, look[a], look + a + 1, alts - a - 1); fputws(_SC(") {\n"), gen);
+				} else if (a == alts - 1 && equal) { fputws(_SC("} else {\n"), gen);
 				} else {
-					fputws(_SC("} else if ("), gen);  GenCond(s1, p2->sub); fputws(_SC(") {\n"), gen);
+					fputws(_SC("} else if ("), gen);  GenLookCond(s1, p2->sub, look[a], look + a + 1, alts - a - 1); fputws(_SC(") {\n"), gen);
 				}
+				if (!tab->recognizer)
+					fwprintf(gen, _SC("#ifdef PARSER_PROFILE\n\tprofile.alts[%d]++;\n#endif\n"), ntAltBase[site] + altNr[a]);
 				GenCode(p2->sub, indent + 1, s1);
 				if (useSwitch) {
 					Indent(indent); fputws(_SC("\tbreak;\n"), gen);
 					Indent(indent); fputws(_SC("}\n"), gen);
 				}
-				p2 = p2->down;
                                 delete s1;
 			}
+			for (int a = 0; a < alts; a++) tab->DeleteLookSets(look[a]);
+			delete [] look;
+			delete [] altNodes;
+			delete [] altNr;
 			Indent(indent);
 			if (equal) {
 				fputws(_SC("}\n"), gen);
@@ -298,7 +474,7 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 			Indent(indent);
 			p2 = p->sub;
 			fputws(_SC("while ("), gen);
-			if (p2->typ == NodeType::wt) {
+			if (p2->typ == NodeType::wt && !tab->recognizer) {
 				s1 = tab->Expected(p2->next, curSy);
 				s2 = tab->Expected(p->next, curSy);
 				fputws(_SC("WeakSeparator("), gen);
@@ -310,7 +486,7 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 				if (p2->up || p2->next == NULL) p2 = NULL; else p2 = p2->next;
 			} else {
 				s1 = tab->First(p2);
-				GenCond(s1, p2);
+				GenOptCond(s1, p);
 			}
 			fputws(_SC(") {\n"), gen);
 			GenCode(p2, indent + 1, s1);
@@ -319,7 +495,7 @@ void ParserGen::GenCode (const Node *p, int indent, BitArray *isChecked) {
 		} if (p->typ == NodeType::opt) {
 			s1 = tab->First(p->sub);
 			Indent(indent);
-			fputws(_SC("if ("), gen); GenCond(s1, p->sub); fputws(_SC(") {\n"), gen);
+			fputws(_SC("if ("), gen); GenOptCond(s1, p); fputws(_SC(") {\n"), gen);
 			GenCode(p->sub, indent + 1, s1);
 			Indent(indent); fputws(_SC("}\n"), gen);
                         delete s1;
@@ -365,7 +541,7 @@ void ParserGen::GenTokensHeader() {
 	fputws(_SC("\n\t};\n"), gen);
 
         // nonterminals
-        fputws(_SC("#ifdef PARSER_WITH_AST\n\tenum eNonTerminals{\n"), gen);
+        fputws(_SC("\tenum eNonTerminals{\n"), gen);
         isFirst = true;
         for (i=0; i<tab->nonterminals.Count; i++) {
                 sym = tab->nonterminals[i];
@@ -374,7 +550,7 @@ void ParserGen::GenTokensHeader() {
 
                 fwprintf(gen , _SC("\t\t_%") _SFMT _SC("=%d"), sym->name, sym->n);
         }
-        fputws(_SC("\n\t};\n#endif\n"), gen);
+        fputws(_SC("\n\t};\n"), gen);
 
 }
 
@@ -385,24 +561,52 @@ void ParserGen::GenCodePragmas() {
 		fputws(_SC("\t\tif (la->kind == "), gen);
 		WriteSymbolOrCode(gen, sym);
 		fputws(_SC(") {\n"), gen);
-		CopySourcePart(sym->semPos, 4);
+		if (!tab->recognizer) CopySourcePart(sym->semPos, 4);
 		fputws(_SC("\t\t}\n"), gen);
 	}
 }
 
+// Writes the body of IsKind: a plain comparison if no token inherits from
+// another one, otherwise a lookup in the inheritance closure (Tab::derivedSets),
+// one bit row for each token that is inherited from.
 void ParserGen::GenTokenBase() {
-	Symbol *sym;
-	fwprintf(gen, _SC("\tstatic const int tBase[%d] = {"), tab->terminals.Count);
-
+	if (!tab->hasInheritance) {
+		fputws(_SC("\treturn t->kind == n;"), gen);
+		return;
+	}
+	int rows = 0;
+	fwprintf(gen, _SC("\tstatic const int derived[%d] = {"), tab->terminals.Count);
 	for (int i=0; i<tab->terminals.Count; i++) {
-		sym = tab->terminals[i];
-                if((i % 20) == 0) fputws(_SC("\n\t\t"), gen);
-                if (sym->inherits == NULL)
-                        fputws(_SC("-1,"), gen); // not inherited
-                else
-                        fwprintf(gen, _SC("%d,"), sym->inherits->n);
+		if ((i % 20) == 0) fputws(_SC("\n\t\t"), gen);
+		if (Sets::Elements(tab->derivedSets[i]) == 1)
+			fputws(_SC("-1,"), gen); // not inherited from
+		else
+			fwprintf(gen, _SC("%d,"), rows++);
 	}
 	fputws(_SC("\n\t};\n"), gen);
+	fwprintf(gen, _SC("\tstatic const unsigned long long kinds[%d][%d] = {\n"), rows, (tab->terminals.Count + 63) / 64);
+	for (int i=0; i<tab->terminals.Count; i++) {
+		if (Sets::Elements(tab->derivedSets[i]) == 1) continue;
+		fputws(_SC("\t\t"), gen); PutBitWords(tab->derivedSets[i]); fputws(_SC(",\n"), gen);
+	}
+	fputws(_SC("\t};\n"), gen);
+	fputws(_SC("\tint k = t->kind, r = derived[n];\n"), gen);
+	fputws(_SC("\treturn k == n || (r >= 0 && ((kinds[r][k >> 6] >> (k & 63)) & 1));"), gen);
+}
+
+// Writes s as initializer of 64 bit words; bit n%64 of word n/64 stands for terminal n.
+void ParserGen::PutBitWords(const BitArray *s) {
+	int words = (tab->terminals.Count + 63) / 64;
+	fputws(_SC("{"), gen);
+	for (int w = 0; w < words; w++) {
+		unsigned long long bits = 0;
+		for (int k = w*64; k < (w+1)*64 && k < tab->terminals.Count; k++) {
+			if ((*s)[k]) bits |= 1ULL << (k % 64);
+		}
+		fwprintf(gen, _SC("0x%016llxULL"), bits);
+		if (w < words-1) fputws(_SC(", "), gen);
+	}
+	fputws(_SC("}"), gen);
 }
 
 void ParserGen::WriteSymbolOrCode(FILE *gen, const Symbol *sym) {
@@ -413,15 +617,264 @@ void ParserGen::WriteSymbolOrCode(FILE *gen, const Symbol *sym) {
 	}
 }
 
+// Base class of the listener L of BasicParser<L> (see Parser.frame); EnterX
+// and ExitX of a nonterminal X call the generic Enter and Exit of L.
+void ParserGen::GenListener() {
+	fputws(_SC("// Base of the listener class L of BasicParser<L>, which is derived from\n"), gen);
+	fputws(_SC("// ParserListener<L> and hides the functions it needs. The parser calls\n"), gen);
+	fputws(_SC("// them directly, so they are inlined.\n"), gen);
+	fputws(_SC("template<class L> struct ParserListener {\n"), gen);
+	fputws(_SC("\tvoid Enter(int) {}\t// the argument is a BasicParser<L>::eNonTerminals\n"), gen);
+	fputws(_SC("\tvoid Exit(int) {}\n"), gen);
+	fputws(_SC("\tvoid OnToken(int, const Token *) {}\t// a terminal of the given kind was recognized\n"), gen);
+	for (int i=0; i<tab->nonterminals.Count; i++) {
+		Symbol *sym = tab->nonterminals[i];
+		fwprintf(gen, _SC("\tvoid Enter%") _SFMT _SC("() { static_cast<L*>(this)->Enter(BasicParser<L>::_%") _SFMT _SC("); }\n"), sym->name, sym->name);
+		fwprintf(gen, _SC("\tvoid Exit%") _SFMT _SC("() { static_cast<L*>(this)->Exit(BasicParser<L>::_%") _SFMT _SC("); }\n"), sym->name, sym->name);
+	}
+	fputws(_SC("};\n\n"), gen);
+}
+
 void ParserGen::GenProductionsHeader() {
 	Symbol *sym;
-	for (int i=0; i<tab->nonterminals.Count; i++) {
-		sym = tab->nonterminals[i];
-		curSy = sym;
-		fwprintf(gen, _SC("\tvoid %") _SFMT _SC("_NT("), sym->name);
-		CopySourcePart(sym->attrPos, 0);
-		fputws(_SC(");\n"), gen);
+	if (genTables) {
+		for (int i=0; i<tab->nonterminals.Count; i++) {
+			sym = tab->nonterminals[i];
+			if (sym->semPos == NULL) continue;
+			StringBuilder members, inits;
+			SplitLocals(sym, members, inits);
+			wchar_t *m = members.ToString();
+			fwprintf(gen, _SC("\tstruct %") _SFMT _SC("_Locals { %") _SFMT _SC(" };\n"), sym->name, m);
+			coco_string_delete(m);
+		}
+		if (tableLocals) fputws(_SC("\tvoid *NewLocals(int nt);\n\tvoid DeleteLocals(int nt, void *locals);\n\tvoid Action(int n, void *locals);\n"), gen);
+		else fputws(_SC("\tvoid Action(int n);\n"), gen);
+		fputws(_SC("\tbool Resolve(int n);\n"), gen);
+	} else {
+		for (int i=0; i<tab->nonterminals.Count; i++) {
+			sym = tab->nonterminals[i];
+			curSy = sym;
+			fwprintf(gen, _SC("\tvoid %") _SFMT _SC("_NT("), sym->name);
+			if (!tab->recognizer) CopySourcePart(sym->attrPos, 0);
+			fputws(_SC(");\n"), gen);
+		}
 	}
+	fputws(_SC("\tvoid ListenerEnter(int nt);\n\tvoid ListenerExit(int nt);\n"), gen);
+}
+
+bool ParserGen::AstPruned() {
+	return tab->astPrune || tab->astKeep.Count > 0 || tab->astDrop.Count > 0;
+}
+
+void ParserGen::CheckAstOptions(TArrayList<wchar_t*> &names, const wchar_t *option) {
+	const size_t formatLen = 200;
+	wchar_t format[formatLen];
+	for (int i=0; i<names.Count; i++) {
+		Symbol *sym = tab->FindSym(names[i]);
+		if (sym == NULL || sym->typ != NodeType::nt) {
+			coco_swprintf(format, formatLen, _SC("%") _SFMT _SC(": %") _SFMT _SC(" is not a nonterminal"), option, names[i]);
+			errors->Warning(format);
+		}
+	}
+}
+
+// AstMode in Parser.frame: 0 keep, 1 collapse, 2 drop; the root is always kept
+int ParserGen::AstMode(const Symbol *sym) {
+	if (sym == tab->gramSy) return 0;
+	for (int i=0; i<tab->astDrop.Count; i++)
+		if (coco_string_equal(tab->astDrop[i], sym->name)) return 2;
+	for (int i=0; i<tab->astKeep.Count; i++)
+		if (coco_string_equal(tab->astKeep[i], sym->name)) return 0;
+	return tab->astPrune ? 1 : 0;
+}
+
+// names of the nonterminals, indexed by eNonTerminals
+void ParserGen::GenNtNames() {
+	fputws(_SC("#if defined(PARSER_WITH_AST) || defined(PARSER_PROFILE)\nstatic const wchar_t * const ntNames[] = {"), gen);
+	for (int i=0; i<tab->nonterminals.Count; i++)
+		fwprintf(gen, _SC("%s_SC(\"%") _SFMT _SC("\")"), i > 0 ? ", " : "", tab->nonterminals[i]->name);
+	fputws(_SC("};\n#endif\n"), gen);
+	if (AstPruned()) {
+		fputws(_SC("#ifdef PARSER_WITH_AST\nstatic const char ntAstModes[] = {"), gen);
+		for (int i=0; i<tab->nonterminals.Count; i++)
+			fwprintf(gen, _SC("%s%d"), i > 0 ? ", " : "", AstMode(tab->nonterminals[i]));
+		fputws(_SC("};\n#endif\n"), gen);
+	}
+	fputws(_SC("\n"), gen);
+}
+
+// true if the source texts at a and b are equal
+bool ParserGen::SameSource(const Position *a, const Position *b) {
+	if (a->end - a->beg != b->end - b->beg) return false;
+	int oldPos = buffer->GetPos();
+	bool same = true;
+	for (int i = 0; same && i < a->end - a->beg; i++) {
+		buffer->SetPos(a->beg + i); int ch = buffer->Read();
+		buffer->SetPos(b->beg + i); same = ch == buffer->Read();
+	}
+	buffer->SetPos(oldPos);
+	return same;
+}
+
+// Name of the function that a resolver starts with, e.g. IsCall for
+// IF(!IsCall()), or NULL.
+wchar_t *ParserGen::ResolverFunction(const Position *pos) {
+	wchar_t *text = SourceText(pos);
+	const wchar_t *s = text;
+	while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n' || *s == '!' || *s == '(') s++;
+	int len = 0;
+	while (IsIdentChar(s[len])) len++;
+	wchar_t *name = len > 0 ? coco_string_create(s, 0, len) : NULL;
+	coco_string_delete(text);
+	return name;
+}
+
+// $memoResolvers=true memoizes every resolver, $memoResolvers=<name> only the
+// resolvers that start with a call of the function <name>. A result is kept
+// while la stays the same token, so only resolvers that depend on the tokens
+// alone may be memoized, not those that test semantic state.
+bool ParserGen::Memoized(const Position *pos) {
+	if (tab->memoResolvers) return true;
+	if (tab->memoNames.Count == 0) return false;
+	wchar_t *name = ResolverFunction(pos);
+	bool found = false;
+	for (int i=0; i<tab->memoNames.Count && !found && name != NULL; i++)
+		found = coco_string_equal(name, tab->memoNames[i]);
+	coco_string_delete(name);
+	return found;
+}
+
+void ParserGen::CheckMemoOptions() {
+	const size_t formatLen = 200;
+	wchar_t format[formatLen];
+	memoAny = false;
+	for (int k=-1; k<tab->memoNames.Count; k++) {
+		bool used = false;
+		for (int i=0; i<tab->nodes.Count && !used; i++) {
+			Node *p = tab->nodes[i];
+			if (p->typ != NodeType::rslv) continue;
+			if (k < 0) { used = Memoized(p->pos); continue; }
+			wchar_t *name = ResolverFunction(p->pos);
+			used = name != NULL && coco_string_equal(name, tab->memoNames[k]);
+			coco_string_delete(name);
+		}
+		if (k < 0) memoAny = used;
+		else if (!used) {
+			coco_swprintf(format, formatLen, _SC("$memoResolvers: no resolver calls %") _SFMT, tab->memoNames[k]);
+			errors->Warning(format);
+		}
+	}
+}
+
+// Resolvers with the same text share a number, so that Parser::Resolve has
+// one case for them and their results are memoized together.
+int ParserGen::NewResolver(const Position *pos) {
+	for (int i=0; i<resolvers.Count; i++)
+		if (SameSource(resolvers[i], pos)) return i;
+	resolvers.Add(pos);
+	return resolvers.Count - 1;
+}
+
+// sizes of the ParserProfile tables; the alternatives of the table-driven
+// parser are not counted
+void ParserGen::GenProfileTables() {
+	fwprintf(gen, _SC("#ifdef PARSER_PROFILE\nstatic const int profileNtCount = %d, profileAltCount = %d, profileErrCount = %d;\n"),
+		tab->nonterminals.Count, altCount, errorNr + 1);
+	fputws(_SC("static const int profileAltSites[] = {"), gen);
+	for (int i=0; i<altSites.Count; i++) fwprintf(gen, _SC("%d, "), altSites[i]);
+	fputws(_SC("-1};\n#endif\n\n"), gen);
+}
+
+// Numbers the counters of the alternatives of sym (see CollectAlts) and
+// looks up their hits in the profile.
+void ParserGen::NumberAlts(const Symbol *sym) {
+	ntAlts.Clear(); ntAltBase.Clear(); ntProf.Clear();
+	CollectAlts(sym->graph);
+	int k = 0;
+	bool match = true;
+	for (int i=0; i<ntAlts.Count; i++) {
+		const Node *p = ntAlts[i];
+		int alts = 0;
+		for (const Node *p2 = p; p2 != NULL; p2 = p2->down) alts++;
+		altSites.Add(sym->n); altSites.Add(p->line); altSites.Add(alts);
+		ntAltBase.Add(altCount);
+		altCount += alts;
+		while (k < profSites.Count && profSites[k] != sym->n) k += 4;
+		if (k < profSites.Count && profSites[k+1] == p->line && profSites[k+2] == alts) {
+			ntProf.Add(profSites[k+3]);
+			k += 4;
+		} else {
+			ntProf.Add(-1);
+			if (profSites.Count > 0) match = false;
+		}
+	}
+	while (k < profSites.Count && profSites[k] != sym->n) k += 4;
+	if (k < profSites.Count) match = false;
+	if (!match) {
+		const size_t formatLen = 200;
+		wchar_t format[formatLen];
+		coco_swprintf(format, formatLen, _SC("-profile: the profile of %") _SFMT _SC(" does not match the grammar, it is not used"), sym->name);
+		errors->Warning(sym->line, sym->col, format);
+		int n = ntProf.Count;
+		ntProf.Clear();
+		for (int i=0; i<n; i++) ntProf.Add(-1);
+	}
+}
+
+// Reads the hits of the alternatives from a profile written by
+// Parser::PrintProfile into profSites and profHits.
+void ParserGen::ReadProfile() {
+	char *fileName = coco_string_create_char(tab->profileName);
+	FILE *f = fopen(fileName, "rb");
+	delete [] fileName;
+	if (f == NULL) {
+		wchar_t *message = coco_string_create_append(_SC("-- Cannot open profile: "), tab->profileName);
+		errors->Exception(message);
+		delete [] message;
+		return;
+	}
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char *text = new char[len + 1];
+	len = (long) fread(text, 1, len, f);
+	text[len] = 0;
+	fclose(f);
+
+	const char *nameKey = "{\"name\": \"", *altsKey = "\"alternatives\": [";
+	const char *lineKey = "{\"line\": ", *hitsKey = ", \"hits\": [";
+	const char *s = text;
+	while ((s = strstr(s, nameKey)) != NULL) {
+		s += strlen(nameKey);
+		const char *end = strchr(s, '"');
+		if (end == NULL) break;
+		wchar_t *name = coco_string_create(s, 0, (int) (end - s));
+		Symbol *sym = tab->FindSym(name);
+		coco_string_delete(name);
+		int nt = sym != NULL && sym->typ == NodeType::nt ? sym->n : -1;
+		if ((s = strstr(end, altsKey)) == NULL) break;
+		s += strlen(altsKey);
+		while (strncmp(s, lineKey, strlen(lineKey)) == 0) {
+			char *next;
+			int line = (int) strtol(s + strlen(lineKey), &next, 10);
+			if (strncmp(next, hitsKey, strlen(hitsKey)) != 0) break;
+			s = next + strlen(hitsKey);
+			int first = profHits.Count;
+			while (*s != ']' && *s != 0) {
+				profHits.Add(strtoll(s, &next, 10));
+				if (next == s) break;
+				s = next;
+				if (*s == ',') s++;
+			}
+			if (nt >= 0) {
+				profSites.Add(nt); profSites.Add(line); profSites.Add(profHits.Count - first); profSites.Add(first);
+			}
+			if (strncmp(s, "]}", 2) != 0) break;
+			s += 2;
+			if (*s == ',') s += 2;
+		}
+	}
+	delete [] text;
 }
 
 void ParserGen::GenProductions() {
@@ -430,16 +883,29 @@ void ParserGen::GenProductions() {
 	for (int i=0; i<tab->nonterminals.Count; i++) {
 		sym = tab->nonterminals[i];
 		curSy = sym;
-		fwprintf(gen, _SC("void Parser::%") _SFMT _SC("_NT("), sym->name);
+		fwprintf(gen, _SC("template<class L>\nvoid BasicParser<L>::%") _SFMT _SC("_NT("), sym->name);
+		NumberAlts(sym);
+		if (tab->recognizer) { // only the branches and the tokens
+			fputws(_SC(") {\n"), gen);
+			ba.SetAll(false);
+			GenCode(sym->graph, 2, &ba);
+			fputws(_SC("}\n\n"), gen);
+			continue;
+		}
 		CopySourcePart(sym->attrPos, 0);
 		fputws(_SC(") {\n"), gen);
 		CopySourcePart(sym->semPos, 2);
+		if (i != 0 && sym->attrPos == NULL) // a taken over subtree cannot return attributes
+			fwprintf(gen, _SC("#ifdef PARSER_INCREMENTAL\n\t\tif (Reuse(eNonTerminals::_%") _SFMT _SC(")) return;\n#endif\n"), sym->name);
                 fputws(_SC("#ifdef PARSER_WITH_AST\n"), gen);
-                if(i == 0) fwprintf(gen, _SC("\t\tToken *ntTok = new Token(); ntTok->kind = eNonTerminals::_%") _SFMT _SC("; ntTok->line = 0; ntTok->val = coco_string_create(_SC(\"%") _SFMT _SC("\"));ast_root = new SynTree( ntTok ); ast_stack.Clear(); ast_stack.Add(ast_root);\n"), sym->name, sym->name);
+                if(i == 0) fwprintf(gen, _SC("\t\tAstAddRoot(eNonTerminals::_%") _SFMT _SC(", _SC(\"%") _SFMT _SC("\"));\n"), sym->name, sym->name);
                 else {
                         fwprintf(gen, _SC("\t\tbool ntAdded = AstAddNonTerminal(eNonTerminals::_%") _SFMT _SC(", _SC(\"%") _SFMT _SC("\"), la->line);\n"), sym->name, sym->name);
                 }
                 fputws(_SC("#endif\n"), gen);
+                // guards, so that a return in a semantic action still calls Exit
+                fwprintf(gen, _SC("#ifdef PARSER_PROFILE\n\tProfileGuard profileGuard(profile, eNonTerminals::_%") _SFMT _SC(");\n#endif\n"), sym->name);
+                fwprintf(gen, _SC("\tListenerGuard listenerGuard(this, eNonTerminals::_%") _SFMT _SC(");\n"), sym->name);
                 ba.SetAll(false);
 		GenCode(sym->graph, 2, &ba);
                 fputws(_SC("#ifdef PARSER_WITH_AST\n"), gen);
@@ -449,22 +915,604 @@ void ParserGen::GenProductions() {
 	}
 }
 
-void ParserGen::InitSets() {
-	fwprintf(gen, _SC("\tstatic const bool set[%d][%d] = {\n"), symSet.Count, tab->terminals.Count+1);
+//---------------------------------------------------------------------
+//  Table-driven parser (-parser tables)
+//---------------------------------------------------------------------
 
-	for (int i = 0; i < symSet.Count; i++) {
-		BitArray *s = DerivationsOf(symSet[i]);
+// Instructions of the table-driven parser; the order must match the enum in
+// Parser.frame. Operands are numbers ('n') or labels ('l').
+enum { opExpect, opGet, opGetAny, opExpectWeak, opAny, opError, opSync, opSem,
+       opCall, opRet, opJump, opPredict, opIf, opResolve, opWeakSep, opStop };
+
+static const struct { const char *name; const char *operands; } tableOps[] = {
+	{"opExpect", "n"}, {"opGet", ""}, {"opGetAny", ""}, {"opExpectWeak", "nn"},
+	{"opAny", "nn"}, {"opError", "n"}, {"opSync", "nn"}, {"opSem", "n"},
+	{"opCall", "ln"}, {"opRet", "n"}, {"opJump", "l"}, {"opPredict", "n"},
+	{"opIf", "nl"}, {"opResolve", "nl"}, {"opWeakSep", "nnnl"}, {"opStop", ""}
+};
+
+// Semantic actions are executed in a switch and productions are not C++
+// functions any more, so attributes cannot be passed; local declarations are
+// kept in a struct per production call (see SplitLocals). Grammars that
+// need more are rejected, -parser tables never falls back silently.
+bool ParserGen::TablesSupported() {
+	const size_t formatLen = 200;
+	wchar_t format[formatLen];
+	bool ok = true;
+	tableLocals = false;
+	if (tab->recognizer) {
+		errors->Warning(_SC("-parser tables: cannot be combined with -recognizer"));
+		errors->count++; ok = false;
+	}
+	for (int i=0; i<tab->nonterminals.Count; i++) {
+		Symbol *sym = tab->nonterminals[i];
+		if (sym->attrPos != NULL) {
+			coco_swprintf(format, formatLen, _SC("-parser tables: %") _SFMT _SC(" has attributes"), sym->name);
+			errors->Error(sym->line, sym->col, format);
+			ok = false;
+		}
+		if (sym->semPos != NULL) {
+			StringBuilder members, inits;
+			if (!SplitLocals(sym, members, inits)) {
+				coco_swprintf(format, formatLen, _SC("-parser tables: local declarations of %") _SFMT _SC(" are not of the form type name [= expr] {, name [= expr]};"), sym->name);
+				errors->Error(sym->semPos->line, sym->semPos->col, format);
+				ok = false;
+			}
+			tableLocals = true;
+		}
+	}
+	for (int i=0; i<tab->nodes.Count; i++) {
+		Node *p = tab->nodes[i];
+		if (p->typ == NodeType::nt && p->pos != NULL) {
+			errors->Error(p->line, p->col, _SC("-parser tables: attributes are not supported"));
+			ok = false;
+		}
+	}
+	if (tab->lookahead > 1) {
+		errors->Warning(_SC("-parser tables: $lookahead is not supported"));
+		errors->count++; ok = false;
+	}
+	return ok;
+}
+
+// The recognizer drops the attributes and the local declarations of the
+// productions but keeps their resolvers; grammars whose resolvers use them
+// are rejected.
+bool ParserGen::RecognizerSupported() {
+	const size_t formatLen = 200;
+	wchar_t format[formatLen];
+	bool ok = true;
+	for (int i=0; i<tab->nonterminals.Count; i++) {
+		Symbol *sym = tab->nonterminals[i];
+		if (sym->attrPos == NULL && sym->semPos == NULL) continue;
+		TArrayList<wchar_t*> names;
+		bool known = true;
+		if (sym->semPos != NULL) {
+			StringBuilder members, inits;
+			known = SplitLocals(sym, members, inits, &names);
+		}
+		if (sym->attrPos != NULL) AttributeNames(sym->attrPos, names);
+		TArrayList<const Node*> resolvers;
+		CollectResolvers(sym->graph, resolvers);
+		for (int k=0; k<resolvers.Count; k++) {
+			const Node *p = resolvers[k];
+			wchar_t *text = SourceText(p->pos);
+			if (!known) {
+				coco_swprintf(format, formatLen, _SC("-recognizer: the local declarations of %") _SFMT _SC(" that this resolver may use are dropped"), sym->name);
+				errors->Error(p->line, p->pos->col, format);
+				ok = false;
+			}
+			for (int n=0; known && n<names.Count; n++) {
+				wchar_t *name = names[n];
+				if (UsesName(text, name)) {
+					coco_swprintf(format, formatLen, _SC("-recognizer: the resolver uses %") _SFMT _SC(", an attribute or local declaration of %") _SFMT _SC(", which is dropped"), name, sym->name);
+					errors->Error(p->line, p->pos->col, format);
+					ok = false;
+					break;
+				}
+			}
+			coco_string_delete(text);
+		}
+		for (int n=0; n<names.Count; n++) {
+			wchar_t *name = names[n];
+			coco_string_delete(name);
+		}
+	}
+	return ok;
+}
+
+// Adds the resolvers of the graph p to list.
+void ParserGen::CollectResolvers(const Node *p, TArrayList<const Node*> &list) {
+	while (p != NULL) {
+		if (p->typ == NodeType::alt) {
+			for (const Node *q = p; q != NULL; q = q->down) CollectResolvers(q->sub, list);
+		} else if (p->typ == NodeType::iter || p->typ == NodeType::opt) {
+			CollectResolvers(p->sub, list);
+		} else if (p->typ == NodeType::rslv) {
+			list.Add(p);
+		}
+		if (p->up) break;
+		p = p->next;
+	}
+}
+
+// Adds the names of the formal attributes at pos to names, e.g. v and n for
+// "int &v, int n = 0".
+void ParserGen::AttributeNames(const Position *pos, TArrayList<wchar_t*> &names) {
+	wchar_t *text = SourceText(pos);
+	wchar_t *name = NULL;	// last identifier of the current attribute
+	int depth = 0;			// nesting of brackets and template arguments
+	bool inDefault = false;
+	for (const wchar_t *s = text; ; s++) {
+		int ch = *s;
+		if (ch == 0 || (ch == ',' && depth == 0)) {
+			if (name != NULL) names.Add(name);
+			name = NULL; inDefault = false;
+			if (ch == 0) break;
+		} else if (ch == '(' || ch == '[' || ch == '<') depth++;
+		else if (ch == ')' || ch == ']' || ch == '>') depth--;
+		else if (ch == '=' && depth == 0) inDefault = true;
+		else if (!inDefault && depth == 0 && IsIdentChar(ch) && !(ch >= '0' && ch <= '9')) {
+			const wchar_t *beg = s;
+			while (IsIdentChar(s[1])) s++;
+			coco_string_delete(name);
+			name = coco_string_create(beg, 0, (int) (s - beg) + 1);
+		}
+	}
+	coco_string_delete(text);
+}
+
+wchar_t *ParserGen::SourceText(const Position *pos) {
+	StringBuilder text;
+	int oldPos = buffer->GetPos();
+	buffer->SetPos(pos->beg);
+	while (buffer->GetPos() < pos->end) text.Append(buffer->Read());
+	buffer->SetPos(oldPos);
+	return text.ToString();
+}
+
+// Splits the local declarations of sym for the table-driven parser, which
+// keeps them in a struct <sym>_Locals per production call: members gets the
+// declarations without their initializers, inits the assignments of the
+// initializers (executed when the production is entered) and names the
+// declared names. Only declarations "type name [= expr] {, name [= expr]};"
+// are accepted, without references, functions or const values.
+bool ParserGen::SplitLocals(const Symbol *sym, StringBuilder &members, StringBuilder &inits, TArrayList<wchar_t*> *names) {
+	wchar_t *text = SourceText(sym->semPos);
+	const wchar_t *s = text;
+	bool ok = true, inInit = false, firstDecl = true, isConst = false, isPtr = false, isArray = false;
+	int idents = 0, depth = 0; // identifiers of the current declarator, nesting in an initializer
+	int angle = 0;             // nesting of template arguments
+	wchar_t *name = NULL;      // last identifier of the current declarator
+	bool named = false;        // the name of the current declarator is known
+	bool space = false;        // blanks before the next identifier or '*'
+	while (ok) {
+		int ch = *s;
+		if (ch == '/' && s[1] == '/') {
+			while (*s != 0 && *s != '\n') s++;
+			continue;
+		}
+		if (ch == '/' && s[1] == '*') {
+			s += 2;
+			while (*s != 0 && !(s[0] == '*' && s[1] == '/')) s++;
+			if (*s != 0) s += 2;
+			continue;
+		}
+		if (inInit) {
+			if (ch == 0 || (depth == 0 && (ch == ',' || ch == ';'))) {
+				inits.Append(_SC(";\n"));
+				inInit = false;
+				continue;
+			}
+			if (ch == '"' || ch == '\'') {
+				inits.Append(*s++);
+				while (*s != 0 && *s != ch) { if (*s == '\\' && s[1] != 0) inits.Append(*s++); inits.Append(*s++); }
+				if (*s != 0) inits.Append(*s++);
+				continue;
+			}
+			if (ch == '(' || ch == '[' || ch == '{') depth++;
+			else if (ch == ')' || ch == ']' || ch == '}') depth--;
+			inits.Append(ch == '\r' || ch == '\n' || ch == '\t' ? ' ' : ch);
+			s++;
+			continue;
+		}
+		if ((ch == '[' || ch == '=' || (ch == ',' && angle == 0) || ch == ';' || ch == 0) && !named && (idents > 0 || ch != 0)) {
+			// the declarator ends with its name
+			if (name == NULL || idents < (firstDecl ? 2 : 1) || (isConst && !isPtr)) { ok = false; break; }
+			if (names != NULL) names->Add(coco_string_create(name));
+			named = true;
+		}
+		if (ch == 0) {
+			if (idents > 0) members.Append(_SC(";"));
+			break;
+		}
+		if (IsIdentChar(ch) && !(ch >= '0' && ch <= '9')) {
+			const wchar_t *beg = s;
+			while (IsIdentChar(*s)) s++;
+			coco_string_delete(name);
+			name = coco_string_create(beg, 0, (int) (s - beg));
+			if (named || coco_string_equal(name, _SC("static")) || coco_string_equal(name, _SC("extern"))
+				|| coco_string_equal(name, _SC("typedef"))) { ok = false; break; }
+			if (coco_string_equal(name, _SC("const"))) isConst = true;
+			else idents++;
+			if (space && members.GetLength() > 0) members.Append(' ');
+			members.Append(name);
+			space = false;
+			continue;
+		}
+		switch (ch) {
+			case '[':
+				isArray = true;
+				while (*s != 0 && *s != ']') members.Append(*s++);
+				if (*s == 0) ok = false; else members.Append(*s++);
+				continue;
+			case '=':
+				if (isArray) { ok = false; break; }
+				inits.Append(_SC("\t\t\t")); inits.Append(name); inits.Append(_SC(" = "));
+				inInit = true; depth = 0;
+				while (s[1] == ' ' || s[1] == '\t' || s[1] == '\r' || s[1] == '\n') s++;
+				break;
+			case ',': case ';':
+				members.Append(ch);
+				if (ch == ',' && angle > 0) break;
+				if (ch == ';') { firstDecl = true; isConst = false; angle = 0; } else firstDecl = false;
+				idents = 0; isPtr = false; isArray = false; named = false;
+				break;
+			case '*':
+				isPtr = true;
+				if (space && members.GetLength() > 0) members.Append(' ');
+				members.Append(ch);
+				space = false;
+				break;
+			case '<': case '>':
+				angle += ch == '<' ? 1 : -1;
+				members.Append(ch);
+				break;
+			case ':':
+				members.Append(ch);
+				break;
+			case ' ': case '\t': case '\r': case '\n':
+				space = true;
+				break;
+			default:
+				ok = false; // references, functions, statements
+		}
+		s++;
+	}
+	coco_string_delete(name);
+	coco_string_delete(text);
+	return ok;
+}
+
+// Binds the locals of sym that text uses to the struct at locals (an
+// expression of type <sym>_Locals*).
+void ParserGen::GenLocalRefs(const wchar_t *text, const Symbol *sym, const wchar_t *locals, int indent) {
+	StringBuilder members, inits;
+	TArrayList<wchar_t*> names;
+	SplitLocals(sym, members, inits, &names);
+	for (int k=0; k<names.Count; k++) {
+		wchar_t *name = names[k];
+		if (UsesName(text, name)) {
+			Indent(indent);
+			fwprintf(gen, _SC("decltype(%") _SFMT _SC("->%") _SFMT _SC(") &%") _SFMT _SC(" = %") _SFMT _SC("->%") _SFMT _SC(";\n"),
+				locals, name, name, locals, name);
+		}
+		coco_string_delete(name);
+	}
+}
+
+void ParserGen::Emit(int x) {
+	if (codeLen == codeSize) {
+		codeSize = 2 * codeSize + 256;
+		int *newCode = new int[codeSize];
+		for (int i=0; i<codeLen; i++) newCode[i] = code[i];
+		delete [] code; code = newCode;
+	}
+	code[codeLen++] = x;
+}
+
+int ParserGen::NewLabel() {
+	if (labelCount == labelSize) {
+		labelSize = 2 * labelSize + 64;
+		int *newLabels = new int[labelSize];
+		for (int i=0; i<labelCount; i++) newLabels[i] = labels[i];
+		delete [] labels; labels = newLabels;
+	}
+	labels[labelCount] = -1;
+	return labelCount++;
+}
+
+void ParserGen::SetLabel(int l) {
+	labels[l] = codeLen;
+}
+
+// Adds a row of labels to the prediction table; equal rows are shared.
+int ParserGen::NewPredictRow(int *row) {
+	for (int i=0; i<predict.Count; i++) {
+		int *r = predict[i], k = 0;
+		while (k < tab->terminals.Count && r[k] == row[k]) k++;
+		if (k == tab->terminals.Count) { delete [] row; return i; }
+	}
+	predict.Add(row);
+	return predict.Count - 1;
+}
+
+// Continues at label yes if la starts s (or the resolver p holds), otherwise at no.
+void ParserGen::GenTableTest(const BitArray *s, const Node *p, int yes, int no) {
+	if (p->typ == NodeType::rslv) {
+		Emit(opResolve); Emit(NewResolver(p->pos)); Emit(yes);
+		Emit(opJump); Emit(no);
+	} else {
+		BitArray *d = DerivationsOf(s);
+		int *row = new int[tab->terminals.Count];
+		for (int k=0; k<tab->terminals.Count; k++) row[k] = (*d)[k] ? yes : no;
+		delete d;
+		Emit(opPredict); Emit(NewPredictRow(row));
+	}
+}
+
+// Generates the instructions for the graph p; follows the structure of GenCode.
+void ParserGen::GenTableCode (const Node *p, BitArray *isChecked) {
+	const Node *p2;
+	BitArray *s1, *s2;
+	while (p != NULL) {
+		if (p->typ == NodeType::nt) {
+			Emit(opCall); Emit(p->sym->n); Emit(p->sym->n);
+		} else if (p->typ == NodeType::t) {
+			if ((*isChecked)[p->sym->n]) Emit(opGet);
+			else { Emit(opExpect); Emit(p->sym->n); }
+		} else if (p->typ == NodeType::wt) {
+			s1 = tab->Expected(p->next, curSy);
+			s1->Or(tab->allSyncSets);
+			Emit(opExpectWeak); Emit(p->sym->n); Emit(NewCondSet(s1));
+			delete s1;
+		} else if (p->typ == NodeType::any) {
+			int acc = Sets::Elements(p->set);
+			if (tab->terminals.Count == (acc + 1) || (acc > 0 && Sets::Equals(p->set, isChecked))) {
+				Emit(opGetAny);
+			} else {
+				GenErrorMsg(altErr, curSy);
+				if (acc > 0) { Emit(opAny); Emit(NewCondSet(p->set)); Emit(errorNr); }
+				else { Emit(opError); Emit(errorNr); }
+			}
+		} else if (p->typ == NodeType::sem) {
+			Emit(opSem); Emit(actions.Count);
+			actions.Add(p->pos); actionNts.Add(curSy->n);
+		} else if (p->typ == NodeType::nt_sync) {
+			GenErrorMsg(syncErr, curSy);
+			Emit(opSync); Emit(NewCondSet(p->set)); Emit(errorNr);
+		} else if (p->typ == NodeType::alt) {
+			s1 = tab->First(p);
+			bool equal = Sets::Equals(s1, isChecked);
+			delete s1;
+			int first = labelCount, n = 0;
+			for (p2 = p; p2 != NULL; p2 = p2->down, n++) NewLabel();
+			int end = NewLabel();
+			int err = equal ? first + n - 1 : NewLabel(); // if equal, the last alternative is the default
+			// The lookahead selects the first alternative that can start with it (the
+			// first one wins on LL(1) conflicts). Resolvers of preceding alternatives
+			// are evaluated before, in grammar order, like in the if-chain of GenCode.
+			int *rslv = new int[n], *pre = new int[n];
+			int nRslv = 0, i = 0;
+			int *row = new int[tab->terminals.Count];
+			BitArray done(tab->terminals.Count);
+			for (p2 = p; p2 != NULL; p2 = p2->down, i++) {
+				rslv[i] = -1; pre[i] = first + i;
+				if (p2->sub->typ == NodeType::rslv) {
+					if (p2->down != NULL || !equal) { rslv[i] = NewResolver(p2->sub->pos); nRslv++; }
+					continue;
+				}
+				if (nRslv > 0) pre[i] = NewLabel();
+				s1 = tab->Expected(p2->sub, curSy);
+				BitArray *d = DerivationsOf(s1);
+				for (int k=0; k<tab->terminals.Count; k++)
+					if ((*d)[k] && !done[k]) { row[k] = pre[i]; done.Set(k, true); }
+				delete d;
+				delete s1;
+			}
+			int dflt = nRslv > 0 ? NewLabel() : err;
+			for (int k=0; k<tab->terminals.Count; k++)
+				if (!done[k]) row[k] = dflt;
+			Emit(opPredict); Emit(NewPredictRow(row));
+			for (i = 0; i <= n; i++) {
+				if (i < n ? pre[i] == first + i : nRslv == 0) continue;
+				SetLabel(i < n ? pre[i] : dflt);
+				for (int j = 0; j < i; j++)
+					if (rslv[j] >= 0) { Emit(opResolve); Emit(rslv[j]); Emit(first + j); }
+				if (i < n || equal) { Emit(opJump); Emit(i < n ? first + i : err); } // else fall through to err
+			}
+			delete [] rslv;
+			delete [] pre;
+			if (!equal) {
+				SetLabel(err);
+				GenErrorMsg(altErr, curSy);
+				Emit(opError); Emit(errorNr);
+				Emit(opJump); Emit(end);
+			}
+			i = 0;
+			for (p2 = p; p2 != NULL; p2 = p2->down, i++) {
+				SetLabel(first + i);
+				s1 = tab->Expected(p2->sub, curSy);
+				GenTableCode(p2->sub, s1);
+				delete s1;
+				if (p2->down != NULL) { Emit(opJump); Emit(end); }
+			}
+			SetLabel(end);
+		} else if (p->typ == NodeType::iter) {
+			int loop = NewLabel(), body = NewLabel(), exit = NewLabel();
+			SetLabel(loop);
+			p2 = p->sub;
+			if (p2->typ == NodeType::wt) {
+				s1 = tab->Expected(p2->next, curSy);
+				s2 = tab->Expected(p->next, curSy);
+				Emit(opWeakSep); Emit(p2->sym->n); Emit(NewCondSet(s1)); Emit(NewCondSet(s2)); Emit(exit);
+				delete s1;
+				delete s2;
+				s1 = new BitArray(tab->terminals.Count);  // for inner structure
+				if (p2->up || p2->next == NULL) p2 = NULL; else p2 = p2->next;
+			} else {
+				s1 = tab->First(p2);
+				GenTableTest(s1, p2, body, exit);
+			}
+			SetLabel(body);
+			GenTableCode(p2, s1);
+			Emit(opJump); Emit(loop);
+			SetLabel(exit);
+			delete s1;
+		} else if (p->typ == NodeType::opt) {
+			int body = NewLabel(), end = NewLabel();
+			s1 = tab->First(p->sub);
+			GenTableTest(s1, p->sub, body, end);
+			SetLabel(body);
+			GenTableCode(p->sub, s1);
+			SetLabel(end);
+			delete s1;
+		}
+		if (p->typ != NodeType::eps && p->typ != NodeType::sem && p->typ != NodeType::nt_sync)
+			isChecked->SetAll(false);
+		if (p->up) break;
+		p = p->next;
+	}
+}
+
+// Generates the instructions of all productions, preceded by a call of the
+// grammar symbol, and the dispatch functions for actions and resolvers.
+void ParserGen::GenTableProductions() {
+	Symbol *sym;
+	BitArray ba(tab->terminals.Count);
+	for (int i=0; i<tab->nonterminals.Count; i++) NewLabel();
+	Emit(opCall); Emit(tab->gramSy->n); Emit(tab->gramSy->n);
+	Emit(opStop);
+	for (int i=0; i<tab->nonterminals.Count; i++) {
+		sym = tab->nonterminals[i];
+		curSy = sym;
+		SetLabel(sym->n);
+		ba.SetAll(false);
+		GenTableCode(sym->graph, &ba);
+		Emit(opRet); Emit(sym->n);
+	}
+
+	if (tableLocals) {
+		// the locals of a production call are created with the call and
+		// deleted on its return, see Parser::Run
+		fputws(_SC("template<class L>\nvoid *BasicParser<L>::NewLocals(int nt) {\n\tswitch (nt) {\n"), gen);
+		for (int i=0; i<tab->nonterminals.Count; i++) {
+			sym = tab->nonterminals[i];
+			if (sym->semPos == NULL) continue;
+			StringBuilder members, inits;
+			SplitLocals(sym, members, inits);
+			wchar_t *in = inits.ToString();
+			fwprintf(gen, _SC("\t\tcase %d: {\n\t\t\t%") _SFMT _SC("_Locals *coco_locals = new (alloc->Alloc(sizeof(%") _SFMT _SC("_Locals))) %") _SFMT _SC("_Locals();\n"),
+				sym->n, sym->name, sym->name, sym->name);
+			GenLocalRefs(in, sym, _SC("coco_locals"), 3);
+			fwprintf(gen, _SC("%") _SFMT _SC("\t\t\treturn coco_locals;\n\t\t}\n"), in);
+			coco_string_delete(in);
+		}
+		fputws(_SC("\t}\n\treturn NULL;\n}\n\n"), gen);
+		fputws(_SC("template<class L>\nvoid BasicParser<L>::DeleteLocals(int nt, void *locals) {\n\tswitch (nt) {\n"), gen);
+		for (int i=0; i<tab->nonterminals.Count; i++) {
+			sym = tab->nonterminals[i];
+			if (sym->semPos != NULL)
+				fwprintf(gen, _SC("\t\tcase %d: ((%") _SFMT _SC("_Locals*) locals)->~%") _SFMT _SC("_Locals(); break;\n"), sym->n, sym->name, sym->name);
+		}
+		fputws(_SC("\t}\n\talloc->Free(locals);\n}\n\n"), gen);
+		fputws(_SC("template<class L>\nvoid BasicParser<L>::Action(int n, void *coco_locals) {\n\tswitch (n) {\n"), gen);
+	} else fputws(_SC("template<class L>\nvoid BasicParser<L>::Action(int n) {\n\tswitch (n) {\n"), gen);
+	for (int i=0; i<actions.Count; i++) {
+		fwprintf(gen, _SC("\t\tcase %d: {\n"), i);
+		sym = tab->nonterminals[actionNts[i]];
+		if (sym->semPos != NULL) {
+			wchar_t *text = SourceText(actions[i]);
+			const size_t formatLen = 200;
+			wchar_t locals[formatLen];
+			coco_swprintf(locals, formatLen, _SC("((%") _SFMT _SC("_Locals*) coco_locals)"), sym->name);
+			GenLocalRefs(text, sym, locals, 3);
+			coco_string_delete(text);
+		}
+		CopySourcePart(actions[i], 3);
+		fputws(_SC("\t\t} break;\n"), gen);
+	}
+	fputws(_SC("\t}\n}\n\n"), gen);
+
+	fputws(_SC("template<class L>\nbool BasicParser<L>::Resolve(int n) {\n\tswitch (n) {\n"), gen);
+	for (int i=0; i<resolvers.Count; i++) {
+		fwprintf(gen, _SC("\t\tcase %d: return "), i);
+		if (Memoized(resolvers[i])) {
+			fwprintf(gen, _SC("MemoHit(%d) ? memo[%d].val : Memo(%d, "), i, i, i);
+			CopySourcePart(resolvers[i], 0);
+			fputws(_SC(");\n"), gen);
+		} else {
+			CopySourcePart(resolvers[i], 0);
+			fputws(_SC(";\n"), gen);
+		}
+	}
+	fputws(_SC("\t}\n\treturn false;\n}\n\n"), gen);
+}
+
+// ListenerEnter and ListenerExit call the listener functions of a nonterminal
+// by its number; they precede the productions, so that constant numbers are
+// inlined to direct calls.
+void ParserGen::GenListenerCalls() {
+	for (int k=0; k<2; k++) {
+		const wchar_t *name = k == 0 ? _SC("Enter") : _SC("Exit");
+		fwprintf(gen, _SC("template<class L>\nvoid BasicParser<L>::Listener%") _SFMT _SC("(int nt) {\n\tif (listener == NULL) return;\n\tswitch (nt) {\n"), name);
+		for (int i=0; i<tab->nonterminals.Count; i++) {
+			Symbol *sym = tab->nonterminals[i];
+			fwprintf(gen, _SC("\t\tcase %d: listener->%") _SFMT _SC("%") _SFMT _SC("(); break;\n"), sym->n, name, sym->name);
+		}
+		fputws(_SC("\t}\n}\n\n"), gen);
+	}
+}
+
+// Writes code[] with one instruction per line and the prediction table,
+// as unsigned short if all values fit.
+void ParserGen::GenTables() {
+	int max = codeLen;
+	for (int i=0; i<codeLen; i++) if (code[i] > max) max = code[i];
+	const char *type = max <= 0xFFFF ? "unsigned short" : "int";
+
+	fwprintf(gen, _SC("\tstatic const %s code[%d] = {\n"), type, codeLen);
+	int pc = 0;
+	while (pc < codeLen) {
+		for (int i=0; i<tab->nonterminals.Count; i++)
+			if (labels[i] == pc) fwprintf(gen, _SC("\t\t// %") _SFMT _SC("\n"), tab->nonterminals[i]->name);
+		int op = code[pc];
+		fwprintf(gen, _SC("\t\t/* %5d */ %s"), pc, tableOps[op].name);
+		const char *operands = tableOps[op].operands;
+		for (int k=0; operands[k] != 0; k++) {
+			int x = code[pc + 1 + k];
+			fwprintf(gen, _SC(", %d"), operands[k] == 'l' ? labels[x] : x);
+		}
+		pc += 1 + (int) strlen(operands);
+		fputws(pc < codeLen ? _SC(",\n") : _SC("\n"), gen);
+	}
+	fputws(_SC("\t};\n"), gen);
+
+	int rows = predict.Count > 0 ? predict.Count : 1;
+	fwprintf(gen, _SC("\tstatic const %s predict[%d][%d] = {\n"), type, rows, tab->terminals.Count);
+	for (int i=0; i<rows; i++) {
 		fputws(_SC("\t\t{"), gen);
-		int j = 0;
-		Symbol *sym;
 		for (int k=0; k<tab->terminals.Count; k++) {
-			sym = tab->terminals[k];
-			fputws(((*s)[sym->n]) ? _SC("T,") : _SC("x,"), gen);
-			++j;
-			if (j%4 == 0) fputws(_SC(" "), gen);
+			if (k > 0) fputws(_SC(","), gen);
+			fwprintf(gen, _SC("%d"), i < predict.Count ? labels[predict[i][k]] : 0);
 		}
-		if (i == symSet.Count-1) fputws(_SC("x}\n"), gen); else fputws(_SC("x},\n"), gen);
-		delete s;
+		fputws(i < rows - 1 ? _SC("},\n") : _SC("}\n"), gen);
+	}
+	fputws(_SC("\t};\n"), gen);
+}
+
+// The sets are written as bit vectors of 64 bit words (see PutBitWords).
+void ParserGen::InitSets() {
+	int words = (tab->terminals.Count + 63) / 64;
+	fwprintf(gen, _SC("\tstatic const unsigned long long set[%d][%d] = {\n"), symSet.Count, words);
+
+	for (int i = 0; i < symSet.Count; i++) {
+		// symSet[0] is the only set not yet derived by NewCondSet
+		BitArray *s = (i == 0) ? DerivationsOf(symSet[i]) : symSet[i];
+		fputws(_SC("\t\t"), gen);
+		PutBitWords(s);
+		if (i == symSet.Count-1) fputws(_SC("\n"), gen); else fputws(_SC(",\n"), gen);
+		if (i == 0) delete s;
 	}
 	fputws(_SC("\t};\n\n"), gen);
 }
@@ -573,6 +1621,16 @@ void ParserGen::WriteParser () {
 	Generator g(tab, errors);
 	int oldPos = buffer->GetPos();  // Pos is modified by CopySourcePart
 	symSet.Add(tab->allSyncSets);
+	genTables = tab->parserTables;
+	if (genTables && !TablesSupported()) return;
+	if (tab->recognizer && !RecognizerSupported()) return;
+	CheckMemoOptions();
+	CheckAstOptions(tab->astKeep, _SC("$astKeep"));
+	CheckAstOptions(tab->astDrop, _SC("$astDrop"));
+	if (tab->profileName != NULL) {
+		if (genTables) errors->Warning(_SC("-profile: the table-driven parser does not depend on the order of alternatives, the profile is not used"));
+		else ReadProfile();
+	}
 
 	fram = g.OpenFrame(_SC("Parser.frame"));
 	gen = g.OpenGen(_SC("Parser.h"));
@@ -595,14 +1653,37 @@ void ParserGen::WriteParser () {
 	g.CopyFramePart(_SC("-->headerdef"));
 
 	if (usingPos != NULL) {CopySourcePart(usingPos, 0); fputws(_SC("\n"), gen);}
+	if (genTables) fputws(_SC("#define PARSER_TABLES\n"), gen);
+	if (genTables && tableLocals) fputws(_SC("#define PARSER_TABLE_LOCALS\n"), gen);
+	if (AstPruned()) fputws(_SC("#define PARSER_AST_PRUNE\n"), gen);
+	if (memoAny) fputws(_SC("#define PARSER_RESOLVER_MEMO\n"), gen);
+	if (tab->recognizer) fputws(_SC("#define PARSER_RECOGNIZER\n"), gen);
 	g.CopyFramePart(_SC("-->namespace_open"));
 	int nrOfNs = GenNamespaceOpen(tab->nsName);
 
+	g.CopyFramePart(_SC("-->listener")); GenListener();
 	g.CopyFramePart(_SC("-->constantsheader"));
 	GenTokensHeader();  /* ML 2002/09/07 write the token kinds */
 	fputws(_SC("\tint maxT;\n"), gen);
 	g.CopyFramePart(_SC("-->declarations")); CopySourcePart(tab->semDeclPos, 0);
 	g.CopyFramePart(_SC("-->productionsheader")); GenProductionsHeader();
+
+	// the members of the class template BasicParser
+	g.CopyFramePart(_SC("-->pragmas")); GenCodePragmas();
+	g.CopyFramePart(_SC("-->tbase")); GenTokenBase(); // write all tokens base types
+	g.CopyFramePart(_SC("-->productions")); GenNtNames();
+	GenListenerCalls();
+	if (genTables) GenTableProductions(); else GenProductions();
+	GenProfileTables();
+	if (memoAny) fwprintf(gen, _SC("static const int resolverCount = %d;\n\n"), resolvers.Count);
+	g.CopyFramePart(_SC("-->tables")); if (genTables) GenTables();
+	g.CopyFramePart(_SC("-->parseRoot"));
+	if (genTables) fputws(_SC("\tRun(0);\n"), gen);
+	else fwprintf(gen, _SC("\t%") _SFMT _SC("_NT();\n"), tab->gramSy->name);
+	if (tab->checkEOF) fputws(_SC("\tExpect(0);"), gen);
+	g.CopyFramePart(_SC("-->constants"));
+	fwprintf(gen, _SC("\tmaxT = %d;\n"), tab->terminals.Count-1);
+	g.CopyFramePart(_SC("-->initialization")); InitSets();
 	g.CopyFramePart(_SC("-->namespace_close"));
 	GenNamespaceClose(nrOfNs);
 
@@ -617,13 +1698,6 @@ void ParserGen::WriteParser () {
 	g.CopyFramePart(_SC("-->namespace_open"));
 	nrOfNs = GenNamespaceOpen(tab->nsName);
 
-	g.CopyFramePart(_SC("-->pragmas")); GenCodePragmas();
-	g.CopyFramePart(_SC("-->tbase")); GenTokenBase(); // write all tokens base types
-	g.CopyFramePart(_SC("-->productions")); GenProductions();
-	g.CopyFramePart(_SC("-->parseRoot")); fwprintf(gen, _SC("\t%") _SFMT _SC("_NT();\n"), tab->gramSy->name); if (tab->checkEOF) fputws(_SC("\tExpect(0);"), gen);
-	g.CopyFramePart(_SC("-->constants"));
-	fwprintf(gen, _SC("\tmaxT = %d;\n"), tab->terminals.Count-1);
-	g.CopyFramePart(_SC("-->initialization")); InitSets();
 	g.CopyFramePart(_SC("-->errors")); fwprintf(gen, _SC("%") _SFMT, err);
 	g.CopyFramePart(_SC("-->namespace_close"));
 	GenNamespaceClose(nrOfNs);
@@ -643,7 +1717,9 @@ void ParserGen::WriteStatistics () {
 
 
 ParserGen::ParserGen (Parser *parser) {
-	maxTerm = 3;
+	maskCost = 3;
+	tableCost = 5;
+	switchCost = 6;
 	CR = '\r';
 	LF = '\n';
 	tErr = 0;
@@ -655,12 +1731,21 @@ ParserGen::ParserGen (Parser *parser) {
 	buffer = parser->scanner->buffer;
 	errorNr = -1;
 	usingPos = NULL;
+	genTables = false;
+	memoAny = false;
+	tableLocals = false;
+	code = labels = NULL;
+	codeLen = codeSize = labelCount = labelSize = 0;
+	altCount = 0;
 
 	err = NULL;
 }
 
 ParserGen::~ParserGen () {
     for(int i=0; i<symSet.Count; ++i) delete symSet[i];
+    for(int i=0; i<predict.Count; ++i) delete [] predict[i];
+    delete [] code;
+    delete [] labels;
     delete usingPos;
     coco_string_delete(err);
 }
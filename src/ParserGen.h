@@ -44,7 +44,10 @@ class BitArray;
 class ParserGen
 {
 public:
-	int maxTerm;		// sets of size < maxTerm are enumerated
+	enum CondTest { condRanges, condMask, condTable }; // code for a terminal set test, see CondCost
+	int maskCost;		// estimated costs of the tests, in comparisons
+	int tableCost;
+	int switchCost;		// a switch is used if the if-chain is more expensive
 	char CR;
 	char LF;
 
@@ -61,21 +64,50 @@ public:
 	wchar_t* err; // generated parser error messages
 	TArrayList<BitArray*> symSet;
 
+	bool genTables;     // generate a table-driven parser (-parser tables)
+	int *code;          // its instructions, see GenTableCode
+	int codeLen, codeSize;
+	int *labels;        // code positions of jump targets; labels[n] is the start of nonterminal n
+	int labelCount, labelSize;
+	TArrayList<int*> predict;                // LL(1) prediction table: rows of labels indexed by token kind
+	TArrayList<const Position*> actions;     // semantic actions, executed by Parser::Action
+	TArrayList<int> actionNts;               // nonterminal of each action
+	bool tableLocals;   // some production has local declarations, see SplitLocals
+	TArrayList<const Position*> resolvers;   // resolvers with distinct text, evaluated by Parser::Resolve
+	bool memoAny;       // some resolver is memoized, see Memoized
+
+	int altCount;                  // alternatives counted by PARSER_PROFILE
+	TArrayList<int> altSites;      // nonterminal, line and number of alternatives of each alternative
+	TArrayList<const Node*> ntAlts; // alternative nodes of curSy, see CollectAlts
+	TArrayList<int> ntAltBase;     // index of the first counter of each of ntAlts
+	TArrayList<int> ntProf;        // index of the hits of each of ntAlts in profHits, -1: none
+	TArrayList<int> profSites;     // -profile: nonterminal, line, number of alternatives and index in profHits
+	TArrayList<long long> profHits; // hits of the alternatives in the profile
+
 	Tab *tab;         // other Coco objects
 	FILE* trace;
 	Errors *errors;
 	Buffer *buffer;
 
 	void Indent(int n);
+	bool IndependentAlts(const Node *p);
+	int  AltCost(const Node *p);
 	bool UseSwitch(const Node *p);
+	bool OrderAlts(const Node *p, int site, const Node **alts, int *altNr);
+	void CollectAlts(const Node *p);
+	void NumberAlts(const Symbol *sym);
+	void ReadProfile();
 	void CopyFramePart(const wchar_t* stop);
 	void CopySourcePart(const Position *pos, int indent);
 	int GenNamespaceOpen(const wchar_t* nsName);
 	void GenNamespaceClose(int nrOfNs);
 	void GenErrorMsg(int errTyp, const Symbol *sym);
 	int  NewCondSet(const BitArray *s);
-	void GenCond(const BitArray *s, const Node *p);
-	void PutCaseLabels(const BitArray *s);
+	int  CondCost(const BitArray *s, CondTest &test);
+	void GenCond(const BitArray *s, const Node *p, int depth = 1);
+	void GenLookCond(const BitArray *s, const Node *p, BitArray **look, BitArray ***later, int n);
+	void GenOptCond(const BitArray *s, const Node *p);
+	void PutCaseLabels(const BitArray *s, BitArray *labels);
 	BitArray *DerivationsOf(const BitArray *s);
 	void GenCode(const Node *p, int indent, BitArray *isChecked);
 	void GenTokens();
@@ -84,9 +116,37 @@ public:
 	void GenPragmas();
 	void GenPragmasHeader();
 	void GenCodePragmas();
+	void GenNtNames();
+	void GenProfileTables();
+	bool SameSource(const Position *a, const Position *b);
+	int NewResolver(const Position *pos);
+	wchar_t *ResolverFunction(const Position *pos);
+	bool Memoized(const Position *pos);
+	void CheckMemoOptions();
+	bool AstPruned();
+	void CheckAstOptions(TArrayList<wchar_t*> &names, const wchar_t *option);
+	int AstMode(const Symbol *sym);
 	void GenProductions();
 	void GenProductionsHeader();
+	void GenListener();
+	void GenListenerCalls();
 	void InitSets();
+	bool TablesSupported();
+	wchar_t *SourceText(const Position *pos);
+	bool RecognizerSupported();
+	void CollectResolvers(const Node *p, TArrayList<const Node*> &list);
+	void AttributeNames(const Position *pos, TArrayList<wchar_t*> &names);
+	bool SplitLocals(const Symbol *sym, StringBuilder &members, StringBuilder &inits, TArrayList<wchar_t*> *names = NULL);
+	void GenLocalRefs(const wchar_t *text, const Symbol *sym, const wchar_t *locals, int indent);
+	void Emit(int x);
+	int  NewLabel();
+	void SetLabel(int l);
+	int  NewPredictRow(int *row);
+	void GenTableTest(const BitArray *s, const Node *p, int yes, int no);
+	void GenTableCode(const Node *p, BitArray *isChecked);
+	void GenTableProductions();
+	void GenTables();
+	void PutBitWords(const BitArray *s);
 	void OpenGen(const wchar_t* genName, bool backUp);
         int GenCodeRREBNF(const Node *p, int depth=0);
 	void WriteRREBNF();
@@ -52,8 +52,16 @@ Tab::Tab(Parser *parser) {
 	dummyNode = NewNode(NodeType::eps, (Symbol*)NULL, 0, 0);
 	checkEOF = true;
 	visited = allSyncSets = NULL;
-	srcName = srcDir = nsName = frameDir = outDir = NULL;
+	hasInheritance = false;
+	srcName = srcDir = nsName = frameDir = outDir = profileName = scannerProfileName = NULL;
 	genRREBNF = false;
+	renumberTerminals = false;
+	parserTables = false;
+	recognizer = false;
+	memoResolvers = false;
+	lookahead = 1;
+	nodeSym = NULL;
+	astPrune = false;
 }
 
 Tab::~Tab() {
@@ -62,10 +70,15 @@ Tab::~Tab() {
     for(int i=0; i<nonterminals.Count; ++i) delete nonterminals[i];
     for(int i=0; i<pragmas.Count; ++i) delete pragmas[i];
     for(int i=0; i<terminals.Count; ++i) delete terminals[i];
+    for(int i=0; i<derivedSets.Count; ++i) delete derivedSets[i];
+    for(int i=0; i<astKeep.Count; ++i) { wchar_t *name = astKeep[i]; coco_string_delete(name); }
+    for(int i=0; i<astDrop.Count; ++i) { wchar_t *name = astDrop[i]; coco_string_delete(name); }
+    for(int i=0; i<memoNames.Count; ++i) { wchar_t *name = memoNames[i]; coco_string_delete(name); }
     //delete dummyNode;
     //delete eofSy;
     delete ignored;
     delete visited;
+    delete [] nodeSym;
     delete semDeclPos;
     //delete allSyncSets; deleted by ParserGen.cpp:499
     coco_string_delete(srcName);
@@ -73,6 +86,8 @@ Tab::~Tab() {
     coco_string_delete(nsName);
     coco_string_delete(frameDir);
     coco_string_delete(outDir);
+    coco_string_delete(profileName);
+    coco_string_delete(scannerProfileName);
 }
 
 
@@ -778,7 +793,26 @@ void Tab::RenumberPragmas() {
 	}
 }
 
+// Computes the transitive closure of token inheritance ("TOKENS a : b").
+void Tab::CompInheritance() {
+	hasInheritance = false;
+	for (int i=0; i<terminals.Count; i++) {
+		BitArray *s = new BitArray(terminals.Count);
+		s->Set(i, true);
+		derivedSets.Add(s);
+	}
+	for (int i=0; i<terminals.Count; i++) {
+		Symbol *sym = terminals[i];
+		int depth = 0; // guards against cyclic inheritance
+		for (Symbol *base = sym->inherits; base != NULL && depth < terminals.Count; base = base->inherits, depth++) {
+			derivedSets[base->n]->Set(sym->n, true);
+			hasInheritance = true;
+		}
+	}
+}
+
 void Tab::CompSymbolSets() {
+	CompInheritance();
 	CompDeletableSymbols();
 	CompFirstSets();
 	CompAnySets();
@@ -816,6 +850,143 @@ void Tab::CompSymbolSets() {
 	}
 }
 
+//---------------------------------------------------------------------
+//  Terminal renumbering
+//---------------------------------------------------------------------
+
+// Collects the sets that the generated parser tests in conditions
+// (alternatives, options and iterations), one entry per test.
+void Tab::CollectTestSets(const Node *p, TArrayList<BitArray*> &sets) {
+	while (p != NULL) {
+		if (p->typ == NodeType::alt) {
+			for (const Node *q = p; q != NULL; q = q->down) {
+				CollectTestSets(q->sub, sets);
+				sets.Add(Expected(q->sub, curSy));
+			}
+		} else if (p->typ == NodeType::opt || p->typ == NodeType::iter) {
+			CollectTestSets(p->sub, sets);
+			sets.Add(Expected(p->sub, curSy));
+		}
+		if (p->up) break;
+		p = p->next;
+	}
+}
+
+static void PermuteSet(BitArray *s, const int *newN) {
+	BitArray p(s->getCount());
+	for (int i=0; i<s->getCount(); i++)
+		if ((*s)[i]) p.Set(newN[i], true);
+	*s = p;
+}
+
+// Compares the membership vectors of terminals a and b in reflected binary
+// (Gray code) order: after an odd number of common memberships the order
+// of the next set is reversed, so that its members stay adjacent across
+// the boundary of the enclosing block.
+static int CompareMembership(int a, int b, BitArray **sets, int nSets) {
+	bool reflected = false;
+	for (int k=0; k<nSets; k++) {
+		bool ia = (*sets[k])[a], ib = (*sets[k])[b];
+		if (ia != ib) return (ia != reflected) ? -1 : 1;
+		if (ia) reflected = !reflected;
+	}
+	return a - b;
+}
+
+// Renumbers the terminals so that the sets tested most often occupy
+// consecutive token numbers, which turns conditions and switch labels
+// into a few range checks. Terminals are sorted by their membership in
+// the tested sets, the most frequent set first.
+// EOF keeps 0 and noSym keeps the highest number, so pragma numbers do
+// not change either. Must be called after CompSymbolSets.
+void Tab::RenumberTerminals() {
+	int nT = terminals.Count;
+	if (nT <= 3) return;
+
+	TArrayList<BitArray*> tests;
+	for (int i=0; i<nonterminals.Count; i++) {
+		curSy = nonterminals[i];
+		CollectTestSets(curSy->graph, tests);
+	}
+
+	// merge equal sets, weight them by their number of tests and drop
+	// the trivial ones (a single free terminal or all of them)
+	int nSets = 0;
+	BitArray **sets = new BitArray*[tests.Count + 1];
+	int *weight = new int[tests.Count + 1];
+	for (int i=0; i<tests.Count; i++) {
+		BitArray *s = tests[i];
+		if (hasInheritance) {
+			BitArray *s0 = s->Clone();
+			for (int k=0; k<nT; k++)
+				if ((*s0)[k]) s->Or(derivedSets[k]);
+			delete s0;
+		}
+		s->Set(eofSy->n, false);
+		int members = Sets::Elements(s);
+		int j = 0;
+		while (j < nSets && !Sets::Equals(sets[j], s)) j++;
+		if (j < nSets) weight[j]++;
+		else if (members > 1 && members < nT - 2) {
+			sets[nSets] = s->Clone(); weight[nSets] = 1; nSets++;
+		}
+		delete s;
+	}
+	for (int i=1; i<nSets; i++) { // stable insertion sort, heaviest first
+		BitArray *s = sets[i]; int w = weight[i];
+		int j = i;
+		while (j > 0 && weight[j-1] < w) { sets[j] = sets[j-1]; weight[j] = weight[j-1]; j--; }
+		sets[j] = s; weight[j] = w;
+	}
+
+	// order the free terminals 1..nT-2
+	int *order = new int[nT];
+	for (int i=0; i<nT; i++) order[i] = i;
+	for (int i=2; i<nT-1; i++) {
+		int t = order[i];
+		int j = i;
+		while (j > 1 && CompareMembership(t, order[j-1], sets, nSets) < 0) { order[j] = order[j-1]; j--; }
+		order[j] = t;
+	}
+
+	int *newN = new int[nT];
+	for (int i=0; i<nT; i++) newN[order[i]] = i;
+
+	// apply the permutation to the symbols and all terminal sets
+	Symbol **syms = new Symbol*[nT];
+	BitArray **derived = new BitArray*[nT];
+	for (int i=0; i<nT; i++) { syms[i] = terminals[order[i]]; derived[i] = derivedSets[order[i]]; }
+	terminals.Clear(); derivedSets.Clear();
+	for (int i=0; i<nT; i++) {
+		syms[i]->n = i;
+		terminals.Add(syms[i]);
+		PermuteSet(derived[i], newN);
+		derivedSets.Add(derived[i]);
+	}
+	for (int i=0; i<nonterminals.Count; i++) {
+		Symbol *sym = nonterminals[i];
+		PermuteSet(sym->first, newN);
+		PermuteSet(sym->follow, newN);
+	}
+	for (int i=0; i<nodes.Count; i++) {
+		Node *p = nodes[i];
+		if ((p->typ == NodeType::any || p->typ == NodeType::nt_sync) && p->set != NULL)
+			PermuteSet(p->set, newN);
+	}
+	PermuteSet(allSyncSets, newN);
+
+	if (ddt[6]) {
+		fputws(_SC("\nRenumbered terminals:\n"), trace);
+		for (int i=0; i<nT; i++)
+			if (order[i] != i) fwprintf(trace, _SC("%3d -> %3d  %") _SFMT _SC("\n"), order[i], i, terminals[i]->name);
+	}
+
+	for (int i=0; i<nSets; i++) delete sets[i];
+	delete [] sets; delete [] weight;
+	delete [] order; delete [] newN;
+	delete [] syms; delete [] derived;
+}
+
 //---------------------------------------------------------------------
 //  String handling
 //---------------------------------------------------------------------
@@ -1072,9 +1243,11 @@ int Tab::CheckAlts(Node *p) {
 		if (p->typ == NodeType::alt) {
 			Node *q = p;
 			s0.SetAll(false);
+			int rc0 = rc;
 			while (q != NULL) { // for all alternatives
 				s2 = Expected0(q->sub, curSy);
-				int overlaped = CheckOverlap(&s0, s2, 1);
+				bool resolved = lookahead > 1 && s0.Overlaps(s2) && LookResolves(p, q);
+				int overlaped = resolved ? 0 : CheckOverlap(&s0, s2, 1);
                                 if(overlaped > 0) {
                                         int overlapToken = 0;
                                         /* Find the first overlap token */
@@ -1091,12 +1264,15 @@ int Tab::CheckAlts(Node *p) {
 				CheckAlts(q->sub);
 				q = q->down;
 			}
+			if (rc > rc0 && lookahead > 1) LookError(p);
 		} else if (p->typ == NodeType::opt || p->typ == NodeType::iter) {
 			if (DelSubGraph(p->sub)) LL1Error(4, NULL); // e.g. [[...]]
 			else {
 				s1 = Expected0(p->sub, curSy);
 				s2 = Expected(p->next, curSy);
-				int overlaped = CheckOverlap(s1, s2, 2);
+				bool resolved = lookahead > 1 && s1->Overlaps(s2) && LookResolves(p, NULL);
+				int overlaped = resolved ? 0 : CheckOverlap(s1, s2, 2);
+				if (overlaped > 0 && lookahead > 1) LookError(p);
                                 if(overlaped > 0) {
                                         int overlapToken = 0;
                                         /* Find the first overlap token */
@@ -1130,6 +1306,120 @@ void Tab::CheckLL1() {
 	}
 }
 
+//--------------- LL(k) decisions ($lookahead) ----------------------
+
+void Tab::SetNodeSyms(const Node *p, Symbol *sym) {
+	while (p != NULL) {
+		nodeSym[p->n] = sym;
+		if (p->typ == NodeType::alt) {
+			for (const Node *q = p; q != NULL; q = q->down) {
+				nodeSym[q->n] = sym;
+				SetNodeSyms(q->sub, sym);
+			}
+		} else if (p->typ == NodeType::opt || p->typ == NodeType::iter)
+			SetNodeSyms(p->sub, sym);
+		if (p->up) break;
+		p = p->next;
+	}
+}
+
+// Adds the terminals at the depths d..lookahead of the token sequences that
+// start at p in the production of sym to sets[d-1..lookahead-1]. Behind the
+// end of a production the sequences go on behind every call of it (strong
+// LL(k)), and the terminals of each depth are collected independently, so
+// the sets may allow more sequences than the grammar but never fewer.
+void Tab::Look(const Node *p, const Symbol *sym, int d, BitArray **sets, BitArray *mark) {
+	while (p != NULL) {
+		int m = (d - 1) * nodes.Count + p->n;
+		if ((*mark)[m]) return;
+		mark->Set(m, true);
+		if (p->typ == NodeType::t || p->typ == NodeType::wt || p->typ == NodeType::any) {
+			if (p->typ == NodeType::any) sets[d-1]->Or(p->set);
+			else sets[d-1]->Set(p->sym->n, true);
+			if (d == lookahead) return;
+			d++;
+		} else if (p->typ == NodeType::nt) {
+			Look(p->sym->graph, p->sym, d, sets, mark);
+			return; // the call goes on in LookFollow
+		} else if (p->typ == NodeType::alt) {
+			for (const Node *q = p; q != NULL; q = q->down) Look(q->sub, sym, d, sets, mark);
+			return;
+		} else if (p->typ == NodeType::opt || p->typ == NodeType::iter) {
+			Look(p->sub, sym, d, sets, mark);
+		}
+		p = p->next;
+	}
+	LookFollow(sym, d, sets, mark);
+}
+
+void Tab::LookFollow(const Symbol *sym, int d, BitArray **sets, BitArray *mark) {
+	int m = lookahead * nodes.Count + (d - 1) * nonterminals.Count + sym->n;
+	if ((*mark)[m]) return;
+	mark->Set(m, true);
+	if (sym == gramSy) // Parser::LT repeats EOF
+		for (int i = d; i <= lookahead; i++) sets[i-1]->Set(eofSy->n, true);
+	for (int i = 0; i < nodes.Count; i++) {
+		const Node *p = nodes[i];
+		if (p->typ == NodeType::nt && p->sym == sym && nodeSym[p->n] != NULL)
+			Look(p->next, nodeSym[p->n], d, sets, mark);
+	}
+}
+
+// terminals at the depths 1..lookahead of the sequences that start at p
+BitArray** Tab::LookSets(const Node *p, const Symbol *sym) {
+	if (nodeSym == NULL) {
+		nodeSym = new Symbol*[nodes.Count];
+		for (int i = 0; i < nodes.Count; i++) nodeSym[i] = NULL;
+		for (int i = 0; i < nonterminals.Count; i++) SetNodeSyms(nonterminals[i]->graph, nonterminals[i]);
+	}
+	BitArray **sets = new BitArray*[lookahead];
+	for (int i = 0; i < lookahead; i++) sets[i] = new BitArray(terminals.Count);
+	BitArray mark(lookahead * (nodes.Count + nonterminals.Count));
+	Look(p, sym, 1, sets, &mark);
+	return sets;
+}
+
+void Tab::DeleteLookSets(BitArray **sets) {
+	if (sets == NULL) return;
+	for (int i = 0; i < lookahead; i++) delete sets[i];
+	delete [] sets;
+}
+
+// the first depth at which the sequences of a and b differ, 0 if there is none
+int Tab::LookDepth(BitArray **a, BitArray **b) {
+	for (int d = 1; d <= lookahead; d++)
+		if (!a[d-1]->Overlaps(b[d-1])) return d;
+	return 0;
+}
+
+// true if the alternative q of p can be told apart from the alternatives
+// before it by LookDepth (for an option or iteration p, q == NULL: its
+// contents from its successor); alternatives with a resolver are left to it
+bool Tab::LookResolves(const Node *p, const Node *q) {
+	bool ok = true;
+	if (q != NULL) {
+		if (q->sub->typ == NodeType::rslv) return true;
+		BitArray **sq = LookSets(q->sub, curSy);
+		for (const Node *a = p; a != q && ok; a = a->down) {
+			if (a->sub->typ == NodeType::rslv) continue;
+			BitArray **sa = LookSets(a->sub, curSy);
+			ok = LookDepth(sa, sq) != 0;
+			DeleteLookSets(sa);
+		}
+		DeleteLookSets(sq);
+	} else if (p->sub->typ != NodeType::rslv) {
+		BitArray **sa = LookSets(p->sub, curSy), **sb = LookSets(p->next, curSy);
+		ok = LookDepth(sa, sb) != 0;
+		DeleteLookSets(sa); DeleteLookSets(sb);
+	}
+	return ok;
+}
+
+void Tab::LookError(const Node *p) {
+	wprintf(_SC("  LL1 warning in %") _SFMT _SC(":%d:%d: not resolved with $lookahead=%d (line %d)\n"),
+		curSy->name, curSy->line, curSy->col, lookahead, p->line);
+}
+
 //------------- check if resolvers are legal  --------------------
 
 void Tab::ResErr(const Node *p, const wchar_t* msg) {
@@ -1377,6 +1667,22 @@ void Tab::SetOption(const wchar_t* s) {
 		if (nsName == NULL) nsName = coco_string_create(s + valueIndex);
 	} else if (coco_string_equal_n(_SC("$checkEOF"), s, nameLenght)) {
 		checkEOF = coco_string_equal(_SC("true"), s + valueIndex);
+	} else if (coco_string_equal_n(_SC("$memoResolvers"), s, nameLenght)) {
+		// true memoizes all resolvers, which is only correct if they depend on
+		// the tokens alone; a name memoizes the resolvers calling that function
+		if (coco_string_equal(_SC("true"), s + valueIndex)) memoResolvers = true;
+		else if (!coco_string_equal(_SC("false"), s + valueIndex)) memoNames.Add(coco_string_create(s + valueIndex));
+	} else if (coco_string_equal_n(_SC("$lookahead"), s, nameLenght)) {
+		lookahead = 0;
+		for (const wchar_t *v = s + valueIndex; *v >= '0' && *v <= '9' && lookahead < 100; v++)
+			lookahead = 10 * lookahead + (*v - '0');
+		if (lookahead < 1) lookahead = 1;
+	} else if (coco_string_equal_n(_SC("$astPrune"), s, nameLenght)) {
+		astPrune = coco_string_equal(_SC("true"), s + valueIndex);
+	} else if (coco_string_equal_n(_SC("$astKeep"), s, nameLenght)) {
+		astKeep.Add(coco_string_create(s + valueIndex));
+	} else if (coco_string_equal_n(_SC("$astDrop"), s, nameLenght)) {
+		astDrop.Add(coco_string_create(s + valueIndex));
 	}
 }
 
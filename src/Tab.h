@@ -57,6 +57,8 @@ public:
 	Symbol *eofSy;              // end of file symbol
 	Symbol *noSym;              // used in case of an error
 	BitArray *allSyncSets;      // union of all synchronisation sets
+	TArrayList<BitArray*> derivedSets; // derivedSets[n]: terminals that inherit from terminal n (n included)
+	bool hasInheritance;        // does any token inherit from another one?
 	HashTable literals;         // symbols that are used as literals
 
 	wchar_t* srcName;           // name of the atg file (including path)
@@ -64,9 +66,20 @@ public:
 	wchar_t* nsName;            // namespace for generated files
 	wchar_t* frameDir;          // directory containing the frame files
 	wchar_t* outDir;            // directory for generated files
+	wchar_t* profileName;       // -profile: Parser::PrintProfile output used to order alternatives
+	wchar_t* scannerProfileName; // -scannerProfile: ScannerStats::Print output used to order transitions
 	bool checkEOF;              // should coco generate a check for EOF at
 	                            // the end of Parser.Parse():
 	bool emitLines;             // emit line directives in generated parser
+	bool renumberTerminals;     // renumber terminals so that tested sets become ranges
+	bool parserTables;          // generate a table-driven instead of a recursive descent parser
+	bool recognizer;            // -recognizer: no semantic actions, attributes or recovery
+	bool memoResolvers;         // $memoResolvers: remember resolver results per lookahead token
+	TArrayList<wchar_t*> memoNames; // $memoResolvers=<name>: only resolvers that call these functions
+	int lookahead;              // $lookahead: tokens looked at to resolve LL(1) conflicts, see LookSets
+	bool astPrune;              // $astPrune: collapse single-child nonterminal chains in the AST
+	TArrayList<wchar_t*> astKeep; // $astKeep: nonterminals that always get an AST node
+	TArrayList<wchar_t*> astDrop; // $astDrop: nonterminals whose children go to their parent
 
 	BitArray *visited;          // mark list for graph traversals
 	Symbol *curSy;              // current symbol in computation of sets
@@ -170,7 +183,10 @@ public:
 	void SetupAnys();
 	void CompDeletableSymbols();
 	void RenumberPragmas();
+	void CompInheritance();
 	void CompSymbolSets();
+	void CollectTestSets(const Node *p, TArrayList<BitArray*> &sets);
+	void RenumberTerminals();
 
 	//---------------------------------------------------------------------
 	//  String handling
@@ -209,6 +225,18 @@ public:
 	int CheckAlts(Node *p);
 	void CheckLL1();
 
+	//--------------- LL(k) decisions ($lookahead) ----------------------
+
+	Symbol **nodeSym;           // production of each node, see LookSets
+	void SetNodeSyms(const Node *p, Symbol *sym);
+	void Look(const Node *p, const Symbol *sym, int d, BitArray **sets, BitArray *mark);
+	void LookFollow(const Symbol *sym, int d, BitArray **sets, BitArray *mark);
+	BitArray** LookSets(const Node *p, const Symbol *sym);
+	void DeleteLookSets(BitArray **sets);
+	int LookDepth(BitArray **a, BitArray **b);
+	bool LookResolves(const Node *p, const Node *q);
+	void LookError(const Node *p);
+
 	//------------- check if resolvers are legal  --------------------
 
 	void ResErr(const Node *p, const wchar_t* msg);
@@ -0,0 +1,63 @@
+// The runtime allocates through the CocoAllocator of the scanner: a counting
+// allocator must see every block freed again, and growing large token values
+// in a CocoArenaAllocator must not keep their old copies.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+class CountingAllocator : public CocoAllocator {
+public:
+	int blocks;
+	CountingAllocator() : blocks(0) {}
+	virtual void* Alloc(size_t size) { blocks++; return malloc(size); }
+	virtual void* Realloc(void *p, size_t size) { if (p == NULL) blocks++; return realloc(p, size); }
+	virtual void Free(void *p) { if (p != NULL) blocks--; free(p); }
+};
+
+static std::string LargeTokens(size_t *chars) {
+	static const int sizes[] = { 1 << 20, 70 * 1024, 16 * 1024 };
+	std::string input;
+	*chars = 0;
+	for (int i = 0; i < 3; i++) {
+		input += "print \"" + std::string(sizes[i], 'a') + "\";\n";
+		*chars += sizes[i];
+	}
+	return input;
+}
+
+int main() {
+	int failures = 0;
+	size_t chars;
+	std::string input = LargeTokens(&chars);
+	const unsigned char *buf = (const unsigned char*) input.c_str();
+
+	CountingAllocator counting;
+	Scanner *scanner = new Scanner(buf, (int) input.length(), &counting);
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	if (parser->errors->count != 0) { printf("counting: %d errors\n", parser->errors->count); failures++; }
+	delete parser;
+	delete scanner;
+	if (counting.blocks != 0) { printf("counting: %d blocks not freed\n", counting.blocks); failures++; }
+
+	// a value is copied from the buffer into tval and from there into the
+	// token, so two copies of each value are expected, but not more
+	CocoArenaAllocator arena;
+	scanner = new Scanner(buf, (int) input.length(), &arena);
+	parser = new Parser(scanner);
+	parser->Parse();
+	size_t bound = 4 * chars * sizeof(wchar_t) + 1024 * 1024;
+	if (arena.Used() > bound) {
+		printf("arena: %lu KB used for %lu KB of token values\n",
+			(unsigned long) (arena.Used() / 1024), (unsigned long) (chars * sizeof(wchar_t) / 1024));
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+	arena.Release();
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
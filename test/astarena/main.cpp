@@ -0,0 +1,88 @@
+// The AST arena keeps its nodes, tokens and texts in blocks: a tree over
+// several blocks, with texts longer than a block slot, must hold the tokens
+// of the input, survive Save and AstFile::Open and free all its blocks.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+class CountingAllocator : public CocoAllocator {
+public:
+	int blocks;
+	CountingAllocator() : blocks(0) {}
+	virtual void* Alloc(size_t size) { blocks++; return malloc(size); }
+	virtual void* Realloc(void *p, size_t size) { if (p == NULL) blocks++; return realloc(p, size); }
+	virtual void Free(void *p) { if (p != NULL) blocks--; free(p); }
+};
+
+static int failures = 0;
+
+// the terminals of the subtree of n in input order
+static void Leaves(const AstArena &ast, const AstNode *n, TArrayList<const AstNode*> &leaves) {
+	if (n->token >= 0) leaves.Add(n);
+	for (int i = 0; i < n->count; i++) Leaves(ast, &ast.nodes[n->first + i], leaves);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) return 2;
+	std::string input;
+	for (int i = 0; i < 3000; i++) {
+		char line[100];
+		snprintf(line, sizeof(line), "x%d = %d * (y + \"s%d\");\n", i, i, i);
+		input += line;
+		if (i % 1000 == 0) input += "print \"" + std::string(COCO_AST_BLOCK, 'a' + i / 1000) + "\";\n";
+	}
+	const unsigned char *buf = (const unsigned char*) input.c_str();
+	int len = (int) input.length();
+
+	CountingAllocator counting;
+	Scanner *scanner = new Scanner(buf, len, &counting);
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	const AstArena &ast = parser->ast;
+	if (parser->errors->count != 0 || ast.root < 0) { printf("%d errors\n", parser->errors->count); return 1; }
+	if (ast.nodeCount <= 2 * COCO_AST_BLOCK || ast.longCount != 3) {
+		printf("%d nodes and %d long texts are too few\n", ast.nodeCount, ast.longCount);
+		failures++;
+	}
+
+	TArrayList<const AstNode*> leaves;
+	Leaves(ast, &ast.nodes[ast.root], leaves);
+	Scanner ref(buf, len);
+	for (int i = 0; ; i++) {
+		Token *t = ref.Scan();
+		if (t->kind == 0) {
+			if (i != leaves.Count) { printf("%d leaves for %d tokens\n", leaves.Count, i); failures++; }
+			break;
+		}
+		if (i >= leaves.Count || leaves[i]->kind != t->kind || !coco_string_equal(ast.Val(leaves[i]), t->val)) {
+			printf("leaf %d differs from the token at line %d\n", i, t->line);
+			failures++;
+			break;
+		}
+	}
+
+	AstFile file;
+	if (!ast.Save(argv[1]) || !file.Open(argv[1])) { printf("cannot save and open %s\n", argv[1]); failures++; }
+	else if (file.header->nodeCount != ast.nodeCount || file.header->tokenCount != ast.tokenCount) {
+		printf("the file has %d nodes and %d tokens\n", file.header->nodeCount, file.header->tokenCount);
+		failures++;
+	} else {
+		for (int i = 0; i < ast.tokenCount; i++) {
+			if (!coco_string_equal(file.text + file.tokens[i].val, ast.Text(ast.tokens[i].val))) {
+				printf("the text of token %d differs in the file\n", i);
+				failures++;
+				break;
+			}
+		}
+	}
+	file.Close();
+
+	delete parser;
+	delete scanner;
+	if (counting.blocks != 0) { printf("%d blocks not freed\n", counting.blocks); failures++; }
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
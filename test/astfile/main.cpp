@@ -0,0 +1,90 @@
+// AstArena::Save writes the tree in pre-order: AstFile must give the same
+// nodes, tokens and names as the arena, find children and siblings by the
+// subtree sizes and refuse files that are not complete AST files.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+// compares the subtree of n with the one of f and returns its number of
+// nodes; first is the first token of the subtree or -1
+static int Compare(const AstArena &ast, const AstNode *n, const AstFile &file, const AstFileNode *f, int &first) {
+	if (n->kind != f->kind || (n->token >= 0) != (f->terminal != 0) || n->line != f->line || n->count != f->count
+			|| !coco_string_equal(ast.Val(n), file.Val(f))) {
+		printf("node %s at line %d differs in the file\n", ast.Val(n), n->line);
+		failures++;
+		return f->size;
+	}
+	first = n->token;
+	int size = 1;
+	const AstFileNode *c = file.FirstChild(f);
+	for (int i = 0; i < n->count && failures == 0; i++, c = file.NextSibling(c)) {
+		int sub = -1;
+		size += Compare(ast, &ast.nodes[n->first + i], file, c, sub);
+		if (first < 0) first = sub;
+	}
+	if (failures == 0 && (size != f->size || first != f->token)) {
+		printf("node %s at line %d: size %d, first token %d instead of %d, %d\n",
+			ast.Val(n), n->line, f->size, f->token, size, first);
+		failures++;
+	}
+	return size;
+}
+
+static void Refuse(const char *path, const char *what, const char *data, long len) {
+	FILE *f = fopen(path, "wb");
+	if (f == NULL) { printf("cannot write %s\n", path); failures++; return; }
+	fwrite(data, 1, len, f);
+	fclose(f);
+	AstFile file;
+	if (file.Open(path)) { printf("%s is opened\n", what); failures++; }
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) return 2;
+	char path[1000], bad[1000];
+	snprintf(path, sizeof(path), "%s/Calc.ast", argv[1]);
+	snprintf(bad, sizeof(bad), "%s/bad.ast", argv[1]);
+
+	const char *input = "var x = 1;\nx = 2 * (x + 3) - \"s\";\n/* comment */ print x;\nrange 1..5;\n{ ; }\n";
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	const AstArena &ast = parser->ast;
+	if (parser->errors->count != 0 || ast.root < 0) { printf("%d errors\n", parser->errors->count); return 1; }
+
+	AstFile file;
+	if (!ast.Save(path) || !file.Open(path)) {
+		printf("cannot save and open %s\n", path);
+		failures++;
+	} else if (file.header->nodeCount != ast.nodeCount || file.header->tokenCount != ast.tokenCount) {
+		printf("the file has %d nodes and %d tokens\n", file.header->nodeCount, file.header->tokenCount);
+		failures++;
+	} else {
+		int first;
+		Compare(ast, &ast.nodes[ast.root], file, file.Root(), first);
+		if (failures == 0 && file.NextSibling(file.Root()) != file.nodes + file.header->nodeCount) {
+			printf("the root does not span all nodes\n");
+			failures++;
+		}
+	}
+
+	// the file without its last byte, and with another magic
+	FILE *f = fopen(path, "rb");
+	static char data[1 << 16];
+	long len = f != NULL ? (long) fread(data, 1, sizeof(data), f) : 0;
+	if (f != NULL) fclose(f);
+	file.Close();
+	Refuse(bad, "a truncated file", data, len - 1);
+	data[0] = 'X';
+	Refuse(bad, "a file with another magic", data, len);
+	Refuse(bad, "an empty file", data, 0);
+	if (file.Open("missing.ast")) { printf("a missing file is opened\n"); failures++; }
+
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
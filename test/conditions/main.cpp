@@ -0,0 +1,59 @@
+// The generated conditions are the cheapest by the cost model (see
+// ParserGen::CondCost): each form must be in the generated parser, which
+// must accept the same tokens as the grammar.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+static void Parse(const char *input, int errors, wchar_t picked = 0) {
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->Parse();
+	if (parser->errors->count != errors) {
+		printf("\"%s\": %d errors instead of %d\n", input, parser->errors->count, errors);
+		failures++;
+	} else if (picked != 0 && parser->picked != picked) {
+		printf("\"%s\": picked %c instead of %c\n", input, (char) parser->picked, (char) picked);
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc != 2) {
+		printf("usage: test_conditions <generated Parser.h>\n");
+		return 1;
+	}
+	FILE *f = fopen(argv[1], "rb");
+	if (f == NULL) { printf("cannot open %s\n", argv[1]); return 1; }
+	static char text[1 << 20];
+	text[fread(text, 1, sizeof(text) - 1, f)] = 0;
+	fclose(f);
+	const char *forms[] = {
+		"switch (la->kind) {",                         // Pick
+		"if (la->kind == 17 /* \"x\" */) {",           // Short
+		"while ((la->kind >= 19 /* \"r1\" */ && la->kind <= 21 /* \"r3\" */)) {",
+		"while (((0x",                                 // Spread
+		"while ((la->kind >= _number && la->kind <= _hexnum)) {",
+	};
+	for (int i = 0; i < (int) (sizeof(forms) / sizeof(forms[0])); i++) {
+		if (strstr(text, forms[i]) == NULL) { printf("not generated: %s\n", forms[i]); failures++; }
+	}
+
+	Parse("pick a ; pick g ;", 0, 'g');
+	Parse("pick d ;", 0, 'd');
+	Parse("short y ;", 0, 'y');
+	Parse("pick x ;", 1);
+	Parse("short a ;", 1);
+	Parse("spread a c x r2 z ; run r3 r1 r2 ; num 1 0x2 ;", 0);
+	Parse("spread b ;", 1);
+	Parse("run a ;", 1);
+	Parse("num x ;", 1);
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
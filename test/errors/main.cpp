@@ -0,0 +1,51 @@
+// Diagnostics keep their file names after the scanner is gone, and
+// Errors::Exception reports a fatal error and stops the parse instead of
+// exiting.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int fatals = 0;
+
+static void CountSink(void *data, const Errors *errors, const Diagnostic *d) {
+	if (d->kind == Diagnostic::fatal) fatals++;
+}
+
+int main() {
+	int failures = 0;
+
+	wchar_t *fileName = coco_string_create("bad.txt");
+	Scanner *scanner = new Scanner(fileName);
+	coco_string_delete(fileName);
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->Parse();
+	delete scanner;
+	Errors *errors = parser->errors;
+	if (errors->count != 1 || errors->diagCount != 1) {
+		printf("%d errors instead of 1\n", errors->count);
+		failures++;
+	} else if (errors->diags[0].file == NULL || strcmp(errors->diags[0].file, "bad.txt") != 0 || errors->diags[0].line != 2) {
+		printf("error in %s line %d instead of bad.txt line 2\n",
+			errors->diags[0].file != NULL ? errors->diags[0].file : "(null)", errors->diags[0].line);
+		failures++;
+	}
+	delete parser;
+
+	const char *input = "x = 1; y = ; z = ;";
+	scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	parser = new Parser(scanner);
+	parser->errors->SetSink(CountSink, NULL);
+	parser->errors->Exception(_SC("-- cannot continue\n"));
+	parser->Parse(); // returns, and reports no errors after the fatal one
+	if (fatals != 1 || !parser->errors->Stopped() || parser->errors->count != 1) {
+		printf("fatal: %d sink calls, %d errors, stopped %d\n", fatals, parser->errors->count, parser->errors->Stopped());
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
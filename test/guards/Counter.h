@@ -0,0 +1,19 @@
+#include "Parser.h"
+
+// Checks that every EnterX is followed by ExitX.
+class Counter : public ParserListener<Counter> {
+public:
+	int depth, enters, errors;
+	int open[64];
+
+	Counter() : depth(0), enters(0), errors(0) {}
+	void Enter(int nt) {
+		enters++;
+		if (depth < 64) open[depth] = nt;
+		depth++;
+	}
+	void Exit(int nt) {
+		depth--;
+		if (depth < 0 || (depth < 64 && open[depth] != nt)) errors++;
+	}
+};
@@ -0,0 +1,32 @@
+// A return in a semantic action must not unbalance the Enter and Exit
+// calls of the profile and of the listener.
+#include <stdio.h>
+#include <string.h>
+#include "Counter.h"
+#include "Scanner.h"
+
+int main() {
+	const char *input = "a; skip; ( b; skip; ( skip; ) c; ) skip;";
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	BasicParser<Counter> *parser = new BasicParser<Counter>(scanner);
+	Counter counter;
+	parser->listener = &counter;
+	parser->Parse();
+	int failures = parser->errors->count;
+	if (parser->skipped != 4) { printf("%d skips instead of 4\n", parser->skipped); failures++; }
+	if (counter.depth != 0 || counter.errors != 0) {
+		printf("listener: depth %d after the parse, %d unmatched exits\n", counter.depth, counter.errors);
+		failures++;
+	}
+	for (int nt = 0; nt < parser->profile.ntCount; nt++) {
+		const ParserProfile::Nt *n = &parser->profile.nts[nt];
+		if (n->enters != n->exits || n->active != 0) {
+			printf("profile: %lld enters and %lld exits of %d\n", n->enters, n->exits, nt);
+			failures++;
+		}
+	}
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// GzBuffer must return the bytes of a compressed file at every position:
+// read through, moved back within the overlap and before the window, and
+// as a whole. The scanner must see the same tokens as for the plain input.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+static void Fail(const char *what, int pos) {
+	printf("%s: wrong byte at %d\n", what, pos);
+	failures++;
+}
+
+static void CheckFrom(GzBuffer *b, const std::string &input, int pos, int len, const char *what) {
+	b->SetPos(pos);
+	for (int i = pos; i < pos + len && i < (int) input.length(); i++)
+		if (b->Read() != (unsigned char) input[i]) { Fail(what, i); return; }
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) return 2;
+	std::string input;
+	for (int i = 0; i < 20000; i++) {
+		char line[100];
+		snprintf(line, sizeof(line), "x%d = %d * (y + \"s%d\"); // line %d\n", i, i, i, i);
+		input += line;
+	}
+	int len = (int) input.length();
+	gzFile f = gzopen(argv[1], "wb");
+	if (f == NULL || gzwrite(f, input.c_str(), len) != len) { printf("cannot write %s\n", argv[1]); return 1; }
+	gzclose(f);
+
+	if (GzBuffer::Open("no such file.gz") != NULL) { printf("a missing file was opened\n"); failures++; }
+
+	GzBuffer *b = GzBuffer::Open(argv[1]);
+	CheckFrom(b, input, 0, len, "read through");
+	if (b->Read() != Buffer::EoF) { printf("no EoF\n"); failures++; }
+	CheckFrom(b, input, len - COCO_GZ_OVERLAP, 100, "overlap");
+	CheckFrom(b, input, 10, 100, "before the window");
+	CheckFrom(b, input, len / 2, 100, "forward");
+	int all;
+	const unsigned char *bytes = b->ReadAll(all);
+	if (all != len || memcmp(bytes, input.c_str(), len) != 0) { printf("ReadAll differs\n"); failures++; }
+	delete b;
+
+	Scanner plain((const unsigned char*) input.c_str(), len);
+	Scanner gz(GzBuffer::Open(argv[1]));
+	for (int n = 0; ; n++) {
+		Token *p = plain.Scan(), *g = gz.Scan();
+		if (p->kind != g->kind || p->pos != g->pos || !coco_string_equal(p->val, g->val)) {
+			printf("token %d at line %d differs\n", n, p->line);
+			failures++;
+			break;
+		}
+		if (p->kind == 0) break;
+	}
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
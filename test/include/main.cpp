@@ -0,0 +1,21 @@
+// Parses a.txt, which includes b.txt, which includes c.txt. The token in
+// front of an include pragma must keep the file it was read from.
+#include <stdio.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+int main(int argc, char *argv[]) {
+	if (argc != 2) {
+		printf("usage: test_include <file>\n");
+		return 1;
+	}
+	wchar_t *fileName = coco_string_create(argv[1]);
+	Scanner *scanner = new Scanner(fileName);
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	int failures = parser->failures + parser->errors->count;
+	delete parser;
+	delete scanner;
+	coco_string_delete(fileName);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Reparse after an edit must give the tree and the errors of a parse of the
+// edited input from scratch, and take over the statements away from the edit.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+// the tree with the kinds and positions of all nodes and the texts of the tokens
+static void Tree(const AstArena &ast, const AstNode *n, std::string &s) {
+	char buf[100];
+	snprintf(buf, sizeof(buf), "%d:%d", n->kind, n->line);
+	s += buf;
+	if (n->token >= 0) {
+		const AstToken *t = &ast.tokens[n->token];
+		snprintf(buf, sizeof(buf), ":%d:%d:%d:", t->pos, t->col, t->kind);
+		s += buf;
+		for (const wchar_t *v = ast.Text(t->val); *v != 0; v++) s += (char) *v;
+		s += " ";
+		return;
+	}
+	s += "(";
+	for (int i = 0; i < n->count; i++) Tree(ast, &ast.nodes[n->first + i], s);
+	s += ")";
+}
+
+static std::string Tree(const Parser *parser) {
+	std::string s;
+	if (parser->ast.root >= 0) Tree(parser->ast, &parser->ast.nodes[parser->ast.root], s);
+	for (int i = 0; i < parser->errors->diagCount; i++) {
+		char buf[100];
+		snprintf(buf, sizeof(buf), " error %d:%d", parser->errors->diags[i].line, parser->errors->diags[i].col);
+		s += buf;
+	}
+	return s;
+}
+
+static std::string Statements(int n) {
+	std::string s;
+	for (int i = 0; i < n; i++) {
+		char line[100];
+		snprintf(line, sizeof(line), i % 10 == 5 ? "{ x%d = %d; print x%d; }\n" : "x%d = %d * (y + 1);\n", i, i, i);
+		s += line;
+	}
+	return s;
+}
+
+// replaces removed characters at pos by inserted in text, reparses and
+// compares with a parse from scratch; minReuse: subtrees to take over at least
+static void Edit(Parser *parser, std::string &text, const char *name,
+		int pos, int removed, const char *inserted, int minReuse) {
+	text.replace(pos, removed, inserted);
+	const unsigned char *buf = (const unsigned char*) text.c_str();
+	parser->Reparse(buf, (int) text.length(), pos, removed, (int) strlen(inserted));
+	Scanner *s = new Scanner(buf, (int) text.length());
+	Parser *p = new Parser(s);
+	p->errors->SetSink(NULL, NULL);
+	p->Parse();
+	if (Tree(parser) != Tree(p)) {
+		printf("%s: the tree differs from a parse from scratch\n", name);
+		failures++;
+	}
+	if (parser->reuseCount < minReuse) {
+		printf("%s: %d subtrees taken over instead of %d\n", name, parser->reuseCount, minReuse);
+		failures++;
+	}
+	delete p;
+	delete s;
+}
+
+int main() {
+	const int n = 200;
+	std::string text = Statements(n);
+	Scanner *scanner = new Scanner((const unsigned char*) text.c_str(), (int) text.length());
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->ParseTokens();
+	if (parser->errors->count != 0) { printf("%d errors\n", parser->errors->count); return 1; }
+
+	int mid = (int) text.find("x100 = ") + 7;
+	Edit(parser, text, "change a number", mid, 3, "12345", n - 2);
+	Edit(parser, text, "insert a line", (int) text.find("x50 ="), 0, "var z = 2;\n", n - 2);
+	Edit(parser, text, "remove a line", (int) text.find("x150 ="), (int) text.find("x151 =") - (int) text.find("x150 ="), "", n - 3);
+	Edit(parser, text, "insert an error", mid, 0, "* ", n - 3);
+	Edit(parser, text, "remove the error", mid, 2, "", n - 3);
+	Edit(parser, text, "join two lines", (int) text.find("\nx20 ="), 1, "", n - 3);
+	Edit(parser, text, "insert into a block", (int) text.find("print x25;"), 0, "x = 1; ", n - 3);
+	Edit(parser, text, "open a comment", 0, 0, "/* ", 0);
+	Edit(parser, text, "close the comment", (int) text.find("x10 ="), 0, "*/ ", 0);
+	Edit(parser, text, "append", (int) text.length(), 0, "print 1;\n", n - 20);
+
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
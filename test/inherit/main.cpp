@@ -0,0 +1,39 @@
+// Token inheritance: IsKind and the conditions must accept the tokens that
+// inherit from the expected one directly or indirectly, but not the tokens
+// that are inherited from.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+static void Check(const char *input, int errors, int numbers = -1) {
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->Parse();
+	if (parser->errors->count != errors) {
+		printf("\"%s\": %d errors instead of %d\n", input, parser->errors->count, errors);
+		failures++;
+	} else if (numbers >= 0 && parser->nNumbers != numbers) {
+		printf("\"%s\": %d numbers instead of %d\n", input, parser->nNumbers, numbers);
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+}
+
+int main() {
+	Check("num 1 0x1f 0b101 2 ;", 0, 4);
+	Check("hex 0x1f ; hex 0b1 ;", 0);
+	Check("hex 12 ;", 1);
+	Check("bin 0b1 ;", 0);
+	Check("bin 0x1 ;", 1);
+	Check("bin 7 ;", 1);
+	Check("id a ; id 'b ;", 0);
+	Check("0b11 ; 'c ; 0xa ; d ;", 0);
+	Check("id 0x1 ;", 1);
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+// Token values longer than the scanner heap blocks and the file buffer
+// window (64 KB) must be kept whole, from memory and from a file, also
+// when they are peeked at before they are scanned.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+static void Check(Scanner *s, const std::string &ident, const std::string &str, const char *what) {
+	s->ResetPeek();
+	Token *p = s->Peek();
+	if (p->kind != 1 || coco_string_length(p->val) != (int) ident.length()) {
+		printf("%s: peeked identifier of length %d\n", what, coco_string_length(p->val));
+		failures++;
+	}
+	for (int k = 0; k < 4; k++) {
+		Token *t = s->Scan();
+		const std::string &want = k % 2 == 0 ? ident : str;
+		int len = coco_string_length(t->val);
+		bool same = len == (int) want.length();
+		for (int i = 0; same && i < len; i++) same = t->val[i] == (wchar_t) (unsigned char) want[i];
+		if (!same) { printf("%s: token %d of length %d differs\n", what, k, len); failures++; }
+	}
+	if (s->Scan()->kind != 0) { printf("%s: no EOF\n", what); failures++; }
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) return 2;
+	std::string ident(200 * 1024, 'x');
+	for (size_t i = 0; i < ident.length(); i += 1000) ident[i] = 'a' + i % 26;
+	std::string str = "\"" + std::string(100 * 1024, 's') + "\"";
+	std::string input = ident + " " + str + "\n" + ident + "\n" + str;
+
+	Scanner mem((const unsigned char*) input.c_str(), (int) input.length());
+	Check(&mem, ident, str, "memory");
+
+	FILE *f = fopen(argv[1], "wb");
+	if (f == NULL || fwrite(input.c_str(), 1, input.length(), f) != input.length()) { printf("cannot write %s\n", argv[1]); return 1; }
+	fclose(f);
+	wchar_t *name = coco_string_create(argv[1]);
+	Scanner file(name);
+	Check(&file, ident, str, "file");
+	coco_string_delete(name);
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
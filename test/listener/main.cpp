@@ -0,0 +1,53 @@
+// A listener sees Enter and Exit around every nonterminal and OnToken for
+// every terminal, in the order of the input; an EnterX of the listener
+// replaces Enter for X.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+static const wchar_t * const names[] = { _SC("Calc"), _SC("Stmt"), _SC("Expr"), _SC("Term"), _SC("Factor") };
+
+class Trace : public ParserListener<Trace> {
+public:
+	std::string s;
+	int stmts;
+
+	Trace() : stmts(0) {}
+	void Append(const wchar_t *val) { for (; *val != 0; val++) s += (char) *val; }
+	void Enter(int nt) { Append(names[nt]); s += "( "; }
+	void Exit(int) { s += ") "; }
+	void OnToken(int, const Token *t) { Append(t->val); s += " "; }
+	void EnterStmt() { stmts++; s += "Stmt( "; }
+};
+
+int main() {
+	const char *input = "var x = 1; print x * (2 + 3); { ; }";
+	const char *expected = "Calc( "
+		"Stmt( var x = Expr( Term( Factor( 1 ) ) ) ; ) "
+		"Stmt( print Expr( Term( Factor( x ) * Factor( ( Expr( Term( Factor( 2 ) ) + Term( Factor( 3 ) ) ) ) ) ) ) ; ) "
+		"Stmt( { Stmt( ; ) } ) ) ";
+	int failures = 0;
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	BasicParser<Trace> *parser = new BasicParser<Trace>(scanner);
+	Trace trace;
+	parser->listener = &trace;
+	parser->Parse();
+	if (parser->errors->count != 0 || trace.s != expected || trace.stmts != 4) {
+		printf("%d errors, %d statements, events\n%s\ninstead of\n%s\n",
+			parser->errors->count, trace.stmts, trace.s.c_str(), expected);
+		failures++;
+	}
+	delete parser;
+
+	// the listener is NULL by default: no events
+	scanner->Reset((const unsigned char*) input, (int) strlen(input));
+	parser = new BasicParser<Trace>(scanner);
+	parser->Parse();
+	if (parser->errors->count != 0) { printf("%d errors without a listener\n", parser->errors->count); failures++; }
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
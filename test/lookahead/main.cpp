@@ -0,0 +1,37 @@
+// $lookahead=3: the parser must take the alternative, option and iteration
+// that the second or third token selects.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+static void Check(const char *input, int errors, const int *alts, int n) {
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->Parse();
+	bool same = parser->nAlts == n;
+	for (int i = 0; same && i < n; i++) same = parser->alts[i] == alts[i];
+	if (parser->errors->count != errors || !same) {
+		printf("\"%s\": %d errors, alternatives", input, parser->errors->count);
+		for (int i = 0; i < parser->nAlts; i++) printf(" %d", parser->alts[i]);
+		printf("\n");
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+}
+
+int main() {
+	const int all[] = { 1, 2, 3, 4, 5, 6, 6 };
+	Check("a = 1; f(); go x to 2; go y by 3; use m.n; use n; list a, b, c; list d;", 0, all, 7);
+	// "at" is not expected after "go" "x" (alternative 4), the rest is read as a call
+	const int fourth[] = { 4, 2 };
+	Check("go x at 1;", 1, fourth, 2);
+	const int third[] = { 3, 1 };
+	Check("go x to 1; f = (", 1, third, 2);
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+// With $memoResolvers=IsCall only the resolvers calling IsCall are
+// memoized: Mode() is evaluated again after the action that changes it,
+// while IsCall() is evaluated once per lookahead token.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+int main() {
+	const char *input = "m x y; f() g; h;";
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	int failures = parser->errors->count;
+	if (parser->before != 0 || parser->after != 1) {
+		printf("Mode(): %d before and %d after the action instead of 0 and 1\n", parser->before, parser->after);
+		failures++;
+	}
+	if (parser->calls != 1) { printf("%d calls instead of 1\n", parser->calls); failures++; }
+	// f: f is a call; g: once for both options; h: once
+	if (parser->isCallEvals != 3) { printf("IsCall evaluated %d times instead of 3\n", parser->isCallEvals); failures++; }
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// ParseAll must deliver every input once, in input order, with the results
+// of its own parse, for any number of threads; inputs that cannot be opened
+// or have errors are counted.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static const int inputCount = 40;
+
+struct Results {
+	int next;		// index of the next expected callback
+	int failures;
+};
+
+// input i assigns i and prints i, so its sum is 2 * i; every 7th input has an error
+static void Deliver(void *data, int index, const wchar_t *, Parser *parser) {
+	Results *r = (Results*) data;
+	if (index != r->next) { printf("input %d delivered instead of %d\n", index, r->next); r->failures++; }
+	r->next = index + 1;
+	if (index == inputCount) {
+		if (parser != NULL) { printf("the missing input was opened\n"); r->failures++; }
+		return;
+	}
+	if (parser == NULL) { printf("input %d not opened\n", index); r->failures++; return; }
+	bool bad = index % 7 == 3;
+	if ((parser->errors->count > 0) != bad || (!bad && parser->sum != 2 * index)) {
+		printf("input %d: %d errors, sum %d\n", index, parser->errors->count, parser->sum);
+		r->failures++;
+	}
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) return 2;
+	wchar_t *inputs[inputCount + 1];
+	for (int i = 0; i <= inputCount; i++) {
+		char name[1024];
+		snprintf(name, sizeof(name), "%s/input%d.txt", argv[1], i);
+		inputs[i] = coco_string_create(name);
+		if (i == inputCount) break; // does not exist
+		FILE *f = fopen(name, "w");
+		if (f == NULL) { printf("cannot write %s\n", name); return 1; }
+		for (int k = 0; k < 200 * (i % 5); k++) fprintf(f, "var v%d = %d;\n", k, k);
+		fprintf(f, i % 7 == 3 ? "x = %d +;\n" : "x = %d;\nprint %d;\n", i, i);
+		fclose(f);
+	}
+	int failures = 0;
+	for (int threads = 1; threads <= 4; threads++) {
+		Results r = { 0, 0 };
+		int failed = ParseAll(inputs, inputCount + 1, threads, Deliver, &r);
+		int expected = 1 + (inputCount + 3) / 7;
+		if (failed != expected) { printf("%d threads: %d failed inputs instead of %d\n", threads, failed, expected); r.failures++; }
+		if (r.next != inputCount + 1) { printf("%d threads: %d inputs delivered\n", threads, r.next); r.failures++; }
+		failures += r.failures;
+	}
+	for (int i = 0; i <= inputCount; i++) coco_string_delete(inputs[i]);
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
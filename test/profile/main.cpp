@@ -0,0 +1,58 @@
+// Generated with -profile Calc.json, in which the alternatives of Factor are
+// hit in the order string, "-", ident, number, "(" and "/" more often than
+// "*": the parser must test them in this order, compute the same values and
+// count the hits of its alternatives in the order of the grammar again.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+// checks that the tests follow each other in the function fn of text
+static void Order(const char *text, const char *fn, const char **tests, int n) {
+	const char *p = strstr(text, fn);
+	for (int i = 0; i < n && p != NULL; i++) {
+		p = strstr(p, tests[i]);
+		if (p == NULL) { printf("%s: %s is not tested in profile order\n", fn, tests[i]); failures++; }
+	}
+	if (strstr(text, fn) == NULL) { printf("%s not generated\n", fn); failures++; }
+}
+
+int main(int argc, char *argv[]) {
+	if (argc != 2) {
+		printf("usage: test_profile <generated Parser.h>\n");
+		return 1;
+	}
+	FILE *f = fopen(argv[1], "rb");
+	if (f == NULL) { printf("cannot open %s\n", argv[1]); return 1; }
+	static char text[1 << 20];
+	text[fread(text, 1, sizeof(text) - 1, f)] = 0;
+	fclose(f);
+	const char *factor[] = { "if (la->kind == _string)", "else if (la->kind == 25 /* \"-\" */)",
+		"else if (la->kind == _ident)", "else if ((la->kind >= _number && la->kind <= _hexnum))",
+		"else if (la->kind == _lpar)" };
+	Order(text, "void BasicParser<L>::Factor_NT(", factor, 5);
+	const char *term[] = { "if (la->kind == 27 /* \"/\" */)" };
+	Order(text, "void BasicParser<L>::Term_NT(", term, 1);
+
+	const char *input = "print -(4 / 2) + \"s\" + x * 3; x = 0x10 / 2;";
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	if (parser->errors->count != 0 || parser->sum != 6) {
+		printf("%d errors, sum %d instead of 6\n", parser->errors->count, parser->sum);
+		failures++;
+	}
+	FILE *out = tmpfile();
+	parser->PrintProfile(out);
+	rewind(out);
+	text[fread(text, 1, sizeof(text) - 1, out)] = 0;
+	fclose(out);
+	const char *hits = "{\"line\": 65, \"hits\": [5, 1, 1, 1, 1]}";
+	if (strstr(text, hits) == NULL) { printf("the profile has no %s:\n%s\n", hits, text); failures++; }
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+// $astPrune, $astKeep and $astDrop shape the tree while it is built, in the
+// SynTree and in the arena (PARSER_AST_ARENA), with either parser backend:
+// all must give the same tree.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+static void Append(std::string &s, const wchar_t *val) {
+	for (; *val != 0; val++) s += (char) *val;
+}
+
+// the tree as "name(child child ...)", terminals as their text
+#ifdef PARSER_AST_ARENA
+static void Tree(const AstArena &ast, const AstNode *n, std::string &s) {
+	Append(s, ast.Val(n));
+	if (n->token >= 0) return;
+	s += "(";
+	for (int i = 0; i < n->count; i++) {
+		if (i > 0) s += " ";
+		Tree(ast, &ast.nodes[n->first + i], s);
+	}
+	s += ")";
+}
+#else
+static void Tree(SynTree *n, std::string &s) {
+	Append(s, n->tok->val);
+	if (n->children.Count == 0) return; // every nonterminal of the grammar has children
+	s += "(";
+	for (int i = 0; i < n->children.Count; i++) {
+		if (i > 0) s += " ";
+		Tree(n->children[i], s);
+	}
+	s += ")";
+}
+#endif
+
+int main() {
+	const char *input = "x = 1 + 2 * y; f(1, (2)); g();";
+	const char *expected = "Prune(Stmt(x = Value(Expr(Factor(1) + Term(Factor(2) * Factor(y)))) ;) "
+		"Stmt(f ( Factor(1) , Factor(( Factor(2) )) ) ;) Stmt(g ( ) ;))";
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	std::string tree;
+#ifdef PARSER_AST_ARENA
+	if (parser->ast.root >= 0) Tree(parser->ast, &parser->ast.nodes[parser->ast.root], tree);
+#else
+	if (parser->ast_root != NULL) Tree(parser->ast_root, tree);
+#endif
+	int failures = parser->errors->count;
+	if (tree != expected) {
+		printf("%s\ninstead of\n%s\n", tree.c_str(), expected);
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
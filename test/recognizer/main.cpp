@@ -0,0 +1,34 @@
+// A recognizer (-recognizer) of Calc.atg accepts the same inputs without
+// executing the semantic actions, and stops at the first error.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int failures = 0;
+
+static void Check(const char *input, int errors) {
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->sum = parser->nDecls = parser->nOptions = -1;
+	parser->Parse();
+	if (parser->errors->count != errors) {
+		printf("\"%s\": %d errors instead of %d\n", input, parser->errors->count, errors);
+		failures++;
+	}
+	if (parser->sum != -1 || parser->nDecls != -1 || parser->nOptions != -1) {
+		printf("\"%s\": semantic actions were executed\n", input);
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+}
+
+int main() {
+	Check("var x = 1; $opt x = x * (2 + 3); f(x, 1); print \"s\"; range 1..2; { if (x) ; else print x; }", 0);
+	Check("x = ; y = ; var ;", 1);
+	Check("print 1; print (1; print 2", 1);
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
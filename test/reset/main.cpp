@@ -0,0 +1,66 @@
+// A scanner and parser reused with Scanner::Reset and Parser::Reset must
+// give the same results as new objects, forget the errors of the previous
+// input and, once warm, allocate nothing for a further input but its copy.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+class CountingAllocator : public CocoAllocator {
+public:
+	int blocks, allocs;
+	CountingAllocator() : blocks(0), allocs(0) {}
+	virtual void* Alloc(size_t size) { blocks++; allocs++; return malloc(size); }
+	virtual void* Realloc(void *p, size_t size) { if (p == NULL) { blocks++; allocs++; } return realloc(p, size); }
+	virtual void Free(void *p) { if (p != NULL) blocks--; free(p); }
+};
+
+static const char *inputs[] = {
+	"var a = 1; a = 2 + 3; print a * 4;",
+	"x = (1 + ;",
+	"print 10; print 20; { y = 5; }",
+	"print 10; print 20; { y = 5; }",
+};
+static const int inputCount = sizeof(inputs) / sizeof(inputs[0]);
+
+int main() {
+	int failures = 0;
+	int sums[inputCount], errs[inputCount];
+	for (int i = 0; i < inputCount; i++) {
+		Scanner scanner((const unsigned char*) inputs[i], (int) strlen(inputs[i]));
+		Parser parser(&scanner);
+		parser.errors->SetSink(NULL, NULL);
+		parser.Parse();
+		sums[i] = parser.sum;
+		errs[i] = parser.errors->count;
+	}
+
+	CountingAllocator counting;
+	Scanner *scanner = new Scanner((const unsigned char*) "", 0, &counting);
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	int allocs = 0;
+	for (int i = 0; i < inputCount; i++) {
+		if (i == inputCount - 1) allocs = counting.allocs;
+		scanner->Reset((const unsigned char*) inputs[i], (int) strlen(inputs[i]));
+		parser->Reset();
+		parser->Parse();
+		if (parser->sum != sums[i] || parser->errors->count != errs[i]) {
+			printf("input %d: sum %d and %d errors instead of %d and %d\n",
+				i, parser->sum, parser->errors->count, sums[i], errs[i]);
+			failures++;
+		}
+	}
+	// the last input repeats the one before it; Reset copies the input
+	if (counting.allocs != allocs + 1) {
+		printf("%d allocations for a repeated input\n", counting.allocs - allocs);
+		failures++;
+	}
+	delete parser;
+	delete scanner;
+	if (counting.blocks != 0) { printf("%d blocks not freed\n", counting.blocks); failures++; }
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
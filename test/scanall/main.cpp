@@ -0,0 +1,87 @@
+// Scanner::ScanAll with 1..maxThreads threads must return the same tokens as
+// scanning sequentially: for empty and tiny inputs (fewer characters than
+// threads) and for multi-line inputs whose chunks start inside comments.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Parser.h"
+#include "Scanner.h"
+
+static const int maxThreads = 9;
+static int failures = 0;
+
+static bool SameToken(const Token *a, const Token *b) {
+	return a->kind == b->kind && a->pos == b->pos && a->charPos == b->charPos
+		&& a->line == b->line && a->col == b->col && coco_string_equal(a->val, b->val);
+}
+
+static void Check(const char *name, const std::string &input) {
+	const unsigned char *buf = (const unsigned char*) input.c_str();
+	int len = (int) input.length();
+	Scanner seq(buf, len);
+	int n = 0, size = 64;
+	Token **ref = new Token*[size];
+	for (;;) {
+		Token *t = seq.Scan();
+		if (n == size) {
+			Token **a = new Token*[2 * size];
+			memcpy(a, ref, size * sizeof(Token*));
+			delete [] ref; ref = a; size *= 2;
+		}
+		ref[n++] = t->Clone(); // the scanner reuses its tokens
+		if (t->kind == 0) break;
+	}
+	for (int threads = 1; threads <= maxThreads; threads++) {
+		Scanner s(buf, len);
+		int count;
+		Token *toks = s.ScanAll(threads, count);
+		if (count != n) {
+			printf("%s, %d threads: %d tokens instead of %d\n", name, threads, count, n);
+			failures++;
+			continue;
+		}
+		for (int i = 0; i < n; i++) {
+			if (!SameToken(&toks[i], ref[i])) {
+				printf("%s, %d threads: token %d at line %d col %d differs (line %d col %d)\n",
+					name, threads, i, toks[i].line, toks[i].col, ref[i]->line, ref[i]->col);
+				failures++;
+				break;
+			}
+		}
+		// Scan continues with the tokens of ScanAll
+		for (int i = 0; i < n; i++) {
+			if (s.Scan() != &toks[i]) {
+				printf("%s, %d threads: Scan does not return token %d\n", name, threads, i);
+				failures++;
+				break;
+			}
+		}
+	}
+	for (int i = 0; i < n; i++) delete ref[i];
+	delete [] ref;
+}
+
+int main() {
+	Check("empty", "");
+	Check("tiny", "x=1;");
+	Check("newline", "\n");
+	Check("one line", "var x = 0x10 + 2; print x;");
+
+	std::string lines;
+	for (int i = 0; i < 500; i++) {
+		char line[100];
+		snprintf(line, sizeof(line), "x%d = %d * (y + \"s%d\"); // line %d\n", i, i, i, i);
+		lines += line;
+		if (i % 37 == 0) lines += "/* a comment\n over /* nested */\n several lines */\n";
+	}
+	Check("multi-line", lines);
+
+	// one comment over the whole input: every chunk but the first starts inside it
+	std::string comment = "a = 1;\n/*\n";
+	for (int i = 0; i < 200; i++) comment += "  b = 2;\n";
+	comment += "*/ c = 3;\n";
+	Check("comment", comment);
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
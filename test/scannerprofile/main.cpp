@@ -0,0 +1,45 @@
+// Generated with -scannerProfile Calc.json, a profile of a scan without
+// strings, comments and hex numbers (see COCO_SCANNER_STATS): the scanner
+// must test the transitions the profile never saw as COCO_UNLIKELY, put the
+// states it never entered last and still scan the same tokens.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static int Count(const char *text, const char *s) {
+	int n = 0;
+	for (const char *p = strstr(text, s); p != NULL; p = strstr(p + 1, s)) n++;
+	return n;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc != 2) {
+		printf("usage: test_scannerprofile <generated Scanner.cpp>\n");
+		return 1;
+	}
+	int failures = 0;
+	FILE *f = fopen(argv[1], "rb");
+	if (f == NULL) { printf("cannot open %s\n", argv[1]); return 1; }
+	static char text[1 << 20];
+	text[fread(text, 1, sizeof(text) - 1, f)] = 0;
+	fclose(f);
+	if (Count(text, "states not entered with the profile") != 1) { printf("cold states are not last\n"); failures++; }
+	if (Count(text, "if (COCO_UNLIKELY(") == 0) { printf("no transition is marked as unlikely\n"); failures++; }
+
+	const char *input = "var x = 0x10; /* a /* nested */ comment */ print \"s\" + x; range 1..2;";
+	const char *vals[] = { "var", "x", "=", "0x10", ";", "print", "\"s\"", "+", "x", ";",
+		"range", "1", "..", "2", ";", "" };
+	Scanner scanner((const unsigned char*) input, (int) strlen(input));
+	for (int i = 0; i < (int) (sizeof(vals) / sizeof(vals[0])); i++) {
+		Token *t = scanner.Scan();
+		if (strcmp(t->val, vals[i]) != 0 || (vals[i][0] == 0) != (t->kind == 0)) {
+			printf("token %d: %s instead of %s\n", i, t->val, vals[i]);
+			failures++;
+			break;
+		}
+	}
+
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
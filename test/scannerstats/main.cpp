@@ -0,0 +1,38 @@
+// The counters of COCO_SCANNER_STATS must match a small input: its tokens
+// per kind and their bytes, the comments, the keyword lookups and the
+// backtrack of the CONTEXT token dotnum.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+int main() {
+	const char *input = "var x = 10; /* one */ range 1..2; // two\nprint x;";
+	Scanner scanner((const unsigned char*) input, (int) strlen(input));
+	int tokens = 0, bytes = 0;
+	Token *t;
+	do { // the end of file is counted as a token of its own
+		t = scanner.Scan();
+		tokens++;
+		bytes += coco_string_length(t->val);
+	} while (t->kind != 0);
+	ScannerStats &st = scanner.GetStats();
+	int kindTokens = 0;
+	long long kindBytes = 0;
+	for (int k = 0; k < st.kindCount; k++) { kindTokens += st.kindTokens[k]; kindBytes += st.kindBytes[k]; }
+	int failures = 0;
+	if (st.tokens != tokens || kindTokens != tokens || kindBytes != bytes) {
+		printf("%d tokens (%d by kind, %lld bytes) instead of %d tokens of %d bytes\n",
+			st.tokens, kindTokens, kindBytes, tokens, bytes);
+		failures++;
+	}
+	if (st.comments != 2) { printf("%d comments\n", st.comments); failures++; }
+	// var, x, range, print, x; the first, third and fourth are keywords
+	if (st.keywordLookups != 5 || st.keywordHits != 3) {
+		printf("%d keyword lookups, %d hits\n", st.keywordLookups, st.keywordHits);
+		failures++;
+	}
+	if (st.backtracks != 1) { printf("%d backtracks\n", st.backtracks); failures++; }
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+// The sets of the conditions are tested as 64 bit words: a table row over
+// more than 64 terminals (Wide), a mask at an offset (Narrow) and a range
+// (Any). Each token must be accepted exactly by the lists that hold it.
+// With -renumberTerminals the generated parser (the argument) must test each
+// list as a range of token numbers instead.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static const int wide[] = { 1, 7, 14, 21, 28, 35, 42, 49, 56, 63, 64, 70, 77, 79 };
+static const int narrow[] = { 10, 13, 20, 31, 44, 52, 60, 69 };
+
+static bool Holds(const int *a, int n, int k) {
+	for (int i = 0; i < n; i++) if (a[i] == k) return true;
+	return false;
+}
+
+// parses "<list> <token> ;" and returns whether the token was a member
+static bool Member(const char *list, const char *token, int *failures) {
+	char input[64];
+	snprintf(input, sizeof(input), "%s %s ;", list, token);
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->errors->SetSink(NULL, NULL);
+	parser->Parse();
+	bool member = parser->errors->count == 0;
+	if (member && strcmp(list, "any") != 0 && parser->nMembers != 1) {
+		printf("%s: %d members\n", input, parser->nMembers);
+		(*failures)++;
+	}
+	delete parser;
+	delete scanner;
+	return member;
+}
+
+static void Check(const char *list, const char *token, bool expected, int *failures) {
+	if (Member(list, token, failures) != expected) {
+		printf("%s %s: %s\n", list, token, expected ? "rejected" : "accepted");
+		(*failures)++;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	int failures = 0;
+	if (argc == 2) {
+		FILE *f = fopen(argv[1], "rb");
+		if (f == NULL) { printf("cannot open %s\n", argv[1]); return 1; }
+		static char text[1 << 20];
+		text[fread(text, 1, sizeof(text) - 1, f)] = 0;
+		fclose(f);
+		if (strstr(text, "while (StartOf(") != NULL || strstr(text, "while (((") != NULL) {
+			printf("a list is not tested as a range\n");
+			failures++;
+		}
+	}
+	for (int k = 0; k < 80; k++) {
+		char token[8];
+		snprintf(token, sizeof(token), "k%d", k);
+		Check("wide", token, Holds(wide, sizeof(wide) / sizeof(wide[0]), k), &failures);
+		Check("narrow", token, Holds(narrow, sizeof(narrow) / sizeof(narrow[0]), k), &failures);
+		Check("any", token, true, &failures);
+	}
+	Check("wide", "x", true, &failures);
+	Check("narrow", "x", false, &failures);
+	Check("any", "x", false, &failures);
+	Check("narrow", "wide", false, &failures);
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}
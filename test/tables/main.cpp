@@ -0,0 +1,31 @@
+// The table-driven parser (-parser tables) keeps the local declarations of
+// the productions per call: recursive productions must not share them.
+#include <stdio.h>
+#include <string.h>
+#include "Parser.h"
+#include "Scanner.h"
+
+static const char *input = "1 + 2 * 3;\nx = (1 + 2) * (3 + (4 * 5));\n- 2 * (3 - (1 - 5)) + 1;\n((((7))));\n";
+static const int expected[] = { 7, 1069, -15, 7 };
+
+int main() {
+	Scanner *scanner = new Scanner((const unsigned char*) input, (int) strlen(input));
+	Parser *parser = new Parser(scanner);
+	parser->Parse();
+	int n = (int) (sizeof(expected) / sizeof(expected[0]));
+	int failures = parser->errors->count;
+	if (parser->nValues != n) {
+		printf("%d values instead of %d\n", parser->nValues, n);
+		failures++;
+	}
+	for (int i = 0; i < n && i < parser->nValues; i++) {
+		if (parser->values[i] != expected[i]) {
+			printf("statement %d: %d instead of %d\n", i, parser->values[i], expected[i]);
+			failures++;
+		}
+	}
+	delete parser;
+	delete scanner;
+	if (failures == 0) printf("ok\n");
+	return failures == 0 ? 0 : 1;
+}